@@ -30,7 +30,7 @@ char *stopmsg   = "Stopping Jmax/vmax extraction.";
 
 //============================================================================//
 int main(int argc, char *argv[]) {
-    int Ncyc = 210;
+    int Ncyc, *cycles;
     char *silo_path=NULL, *out_path=NULL, fname[1001];
     
     // Read the command line arguments:
@@ -40,11 +40,13 @@ int main(int argc, char *argv[]) {
     sprintf(fname,"%s/Jmax_vmax_n0_w_mins.dat",out_path);
     FILE *fp = fopen(fname,"w");
     
-    // Write (to a file) the probe data for the requested cycle argument:
-    for(int cyc=1; cyc<=Ncyc; cyc++)
-        Get_Max_Vals(cyc,silo_path,fp);
+    // Write (to a file) the maximum values for each available cycle:
+    cycles = Get_Cycles(silo_path,Ncyc,stopmsg);
+    for(int m=0; m<Ncyc; m++)
+        Get_Max_Vals(cycles[m],silo_path,fp);
         
     fclose(fp);
+    delete [] cycles;
 }
 
 //============================================================================//
@@ -75,11 +77,17 @@ void Get_Max_Vals(int cycle, char *silo_path, FILE *fp) {
     double time;
     char full_name[1001];
     
-    // Load the magnetic field data and its dimensions:
+    // Load the current density and velocity data and their dimensions
+    // (from a single open database):
     sprintf(full_name,"HYM_%0.3d.silo",cycle);
-    time = ReadTime_SILO(silo_path,full_name,"HYM_mesh",stopmsg);
-    ReadVector_SILO(silo_path,full_name,"current_density",current,dims,stopmsg);
-    ReadVector_SILO(silo_path,full_name,"velocity",velocity,dims,stopmsg);
+    SILO_Reader reader(silo_path,full_name,"HYM_mesh",stopmsg);
+    for(int m=0; m<ndims; m++) {
+        current[m] = NULL;
+        velocity[m] = NULL;
+    }
+    time = reader.Time();
+    reader.ReadVector("current_density",current,dims);
+    reader.ReadVector("velocity",velocity,dims);
     
     // Set the boundary indices:
     ib1 = 200; //   3;
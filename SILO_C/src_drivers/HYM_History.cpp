@@ -0,0 +1,355 @@
+//============================================================================//
+/*
+
+Clayton Myers
+HYM_History.cpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Extracts the time histories of HYM variables at a set of points directly from
+the raw binary output (h3d*.d), without converting the cycles to SILO.  The
+values are trilinearly interpolated in (z,r,phi) (phi is periodic) from the
+stencil nodes of each point (see ProbeArray in Interp_Functions), and only
+those nodes are read from each record (see HYMDataObj::ReadPoints_Binary).
+
+The points file lists one point or line of points per line ('#' starts a
+comment line), with z and r in the units of the mesh and phi in degrees:
+    z  r  phi
+    line  z0 r0 phi0  z1 r1 phi1  N     (N evenly spaced points, ends included)
+
+The histories are written to "History.dat" in out_path.  Its header lists the
+points (number, z, r and phi) and each following line holds the cycle, the
+time and the values at each point in turn (the selected variables in the order
+of data_flags, vectors as their (z,r,phi) components).
+
+Command line arguments:
+    (1) data_path  -- Path to the location of the raw binary data files.
+                      Must include leading and trailing slashes.
+    (2) out_path   -- Path to the destination for the history file.
+                      Must include leading and trailing slashes.
+    (3) point_file -- Full path of the points file.
+    (4) data_flags -- String of 1's and 0's to mask which variables are
+                      extracted (as for HYM_SILO: p, n, B, v, J).
+
+Optional arguments (after the four required arguments):
+    --cycles=A:B -- Extract only the cycles in the range [A,B].
+    --mmap     -- Read the points through a memory map of each source file
+                  instead of through positional (pread) reads.
+    --timing   -- Time the indexing, point reads and interpolation of every
+                  cycle and write the calls, seconds, bytes and MB/s of each
+                  stage to History_timing.json and History_timing.csv in
+                  out_path.
+
+*/
+//============================================================================//
+//============================================================================//
+
+#include <HYM_SILO.hpp>
+#include <HYM_DataObj.hpp>
+#include <Interp_Functions.hpp>
+#include <Stage_Timers.hpp>
+
+#include <vector>      // For the point list in Read_Points
+
+//============================================================================//
+//============================================================================//
+void ReadArgs(int,char**,char*&,char*&,char*&,bool*);
+void ReadStatData(char*,int&,int*);
+void Read_Points(char*,int&,float*&,float*&,float*&);
+void Write_History(char*,HYMDataObj**,int,int*,float**,char*);
+
+char *fname_mesh = "hgrid.d";
+char *fname_stat = "hstat.d";
+char *history_name = "History.dat";
+char *stopmsg = "Stopping time history extraction.";
+
+int first_cycle = 1;                // First cycle to extract
+int last_cycle = 0;                 // Last cycle to extract (0 = final cycle)
+
+//============================================================================//
+int main(int argc, char *argv[]) {
+    int Ncyc, dims[ndims];
+    float *mesh_coords[ndims] = {NULL,NULL,NULL};
+    char *data_path=NULL, *out_path=NULL, *point_file=NULL;
+    bool data_flags[nvars];
+
+    // Process the basic run parameters and read in the mesh:
+    ReadArgs(argc,argv,data_path,out_path,point_file,data_flags);
+    ReadStatData(data_path,Ncyc,dims);
+    HYMDataObj::ReadMesh_Binary(data_path,fname_mesh,dims,mesh_coords,stopmsg);
+
+    // Define and initialize the HYM data objects:
+    HYMDataObj *data_objs[nvars];
+    for(int m=0; m<nvars; m++)
+        data_objs[m] = NULL;
+    if(data_flags[0])
+        data_objs[0] = new HYMScalarObj('p',data_path,"h3ds.d",dims,stopmsg);
+    if(data_flags[1])
+        data_objs[1] = new HYMScalarObj('n',data_path,"h3ds_ff.d",dims,stopmsg);
+    if(data_flags[2])
+        data_objs[2] = new HYMVectorObj('B',data_path,"h3db.d",dims,stopmsg);
+    if(data_flags[3])
+        data_objs[3] = new HYMVectorObj('v',data_path,"h3dv.d",dims,stopmsg);
+    if(data_flags[4])
+        data_objs[4] = new HYMVectorObj('J',data_path,"h3dj.d",dims,stopmsg);
+
+    Write_History(out_path,data_objs,Ncyc,dims,mesh_coords,point_file);
+
+    for(int m=0; m<nvars; m++) {
+        if(data_objs[m] != NULL)
+            delete data_objs[m];
+    }
+    for(int m=0; m<ndims; m++)
+        delete [] mesh_coords[m];
+    StageTimer::Write_Report(out_path,"History_timing",stopmsg);
+    return 0;
+}
+
+//============================================================================//
+//============================================================================//
+void ReadArgs(int argc, char **argv, char *&data_path, char *&out_path,
+              char *&point_file, bool *data_flags) {
+    char message[1001];
+
+    // Count the initial command line arguments
+    if(argc < 5) {
+        sprintf(message,"      %s%s\n      %s","An improper number of ",
+                "command line arguments was found.",stopmsg);
+        StopExecution(message);
+    }
+
+    // Distribute the command line arguments:
+    data_path = argv[1];
+    out_path = argv[2];
+    point_file = argv[3];
+    VerifyPath(data_path,stopmsg);
+    VerifyPath(out_path,stopmsg);
+
+    // Convert the data flags to a boolean array of length nvars:
+    if(strlen(argv[4]) != nvars) {
+        sprintf(message,"      %s%s\n         %s %d; %s %s\n      %s",
+                "The data_flags command line argument does not have the ",
+                "proper length:", "Required Length:",nvars,
+                "Received Argument:",argv[4],stopmsg);
+        StopExecution(message);
+    }
+    for(int m=0; m<nvars; m++) {
+        if(argv[4][m] != '0' && argv[4][m] != '1') {
+            sprintf(message,"      %s\n  %s%d;  %s%c.\n        %s\n      %s",
+                "An improper data flag was found:",
+                "      Flag Slot = ",m,"Flag = ", argv[4][m],
+                "Data flags must be either 0 or 1.",stopmsg);
+            StopExecution(message);
+        }
+        data_flags[m] = (argv[4][m] == '1');
+    }
+
+    // Process any optional arguments:
+    for(int m=5; m<argc; m++) {
+        if(strcmp(argv[m],"--mmap") == 0)
+            HYMDataObj::use_mmap = true;
+        else if(strcmp(argv[m],"--timing") == 0)
+            StageTimer::Start();
+        else if(strncmp(argv[m],"--cycles=",9) == 0) {
+            if(sscanf(argv[m]+9,"%d:%d",&first_cycle,&last_cycle) != 2 ||
+               first_cycle < 1 || last_cycle < first_cycle) {
+                sprintf(message,"      %s\"%s\"%s\n      %s",
+                        "The cycle range ",argv[m]+9," is not valid (A:B).",
+                        stopmsg);
+                StopExecution(message);
+            }
+        }
+        else {
+            sprintf(message,"      %s\"%s\"%s\n      %s",
+                    "The optional argument ",argv[m]," is not recognized.",
+                    stopmsg);
+            StopExecution(message);
+        }
+    }
+}
+
+//============================================================================//
+void ReadStatData(char *data_path, int &Ncyc, int *dims) {
+    // Gets the number of cycles (Ncyc) and mesh dimensions (dims) of the run
+    // (see HYM_SILO)
+    char str[1001];
+    ifstream file;
+    OpenInputFile(file,data_path,fname_stat,"ascii",stopmsg);
+    for(int m=0; m<4; m++) { file >> str; }
+    for(int m=0; m<ndims; m++) { file >> str >> dims[m]; }
+    for(int m=0; m<17; m++) { file >> str; }
+    file >> Ncyc;
+    file.close();
+}
+
+//============================================================================//
+void Read_Points(char *point_file, int &Np, float *&z, float *&r,
+                 float *&phi) {
+    // Reads the (z,r,phi) positions of the points (phi in degrees) from the
+    // points file, expanding each line of points
+    vector<float> zv, rv, pv;
+    char line[1001];
+    ifstream file;
+    OpenInputFile(file,"",point_file,"ascii",stopmsg);
+    while(file.getline(line,1001)) {
+        float x0[ndims], x1[ndims];
+        int N;
+        char *c = line;
+        while(*c == ' ' || *c == '\t')
+            c++;
+        if(*c == '#' || *c == '\0' || *c == '\r')
+            continue;
+        if(strncmp(c,"line",4) == 0 &&
+           sscanf(c+4,"%f %f %f %f %f %f %d",&x0[0],&x0[1],&x0[2],
+                  &x1[0],&x1[1],&x1[2],&N) == 7 && N >= 1) {
+            for(int n=0; n<N; n++) {
+                float t = (N > 1) ? (float)n/(N-1) : 0.;
+                zv.push_back(x0[0] + t*(x1[0]-x0[0]));
+                rv.push_back(x0[1] + t*(x1[1]-x0[1]));
+                pv.push_back(x0[2] + t*(x1[2]-x0[2]));
+            }
+        }
+        else if(sscanf(c,"%f %f %f",&x0[0],&x0[1],&x0[2]) == 3) {
+            zv.push_back(x0[0]);
+            rv.push_back(x0[1]);
+            pv.push_back(x0[2]);
+        }
+        else {
+            char message[1001];
+            sprintf(message,"  %s \"%s\" %s\n    %s\n  %s",
+                    "The points file",point_file,
+                    "has a line that is not a point or a line of points:",
+                    line,stopmsg);
+            StopExecution(message);
+        }
+    }
+    file.close();
+
+    Np = (int)zv.size();
+    if(Np == 0) {
+        char message[1001];
+        sprintf(message,"  The points file \"%s\" %s\n  %s",
+                point_file,"lists no points.",stopmsg);
+        StopExecution(message);
+    }
+    z = new float[Np];
+    r = new float[Np];
+    phi = new float[Np];
+    for(int p=0; p<Np; p++) {
+        z[p] = zv[p];
+        r[p] = rv[p];
+        phi[p] = pv[p];
+    }
+}
+
+//============================================================================//
+void Write_History(char *out_path, HYMDataObj **data_objs, int Ncyc,
+                   int *dims, float **mesh_coords, char *point_file) {
+    // Gathers the stencil nodes of the points from each cycle of the selected
+    // variables and writes the interpolated values as one line per cycle
+    int Np, Nnodes, Nvals = 0;
+    float *z, *r, *phi;
+    char outstr[1001];
+    HYMDataObj *first = NULL;
+
+    // Stencils of the points on the mesh:
+    Read_Points(point_file,Np,z,r,phi);
+    float *phi_rad = new float[Np];
+    for(int p=0; p<Np; p++)
+        phi_rad[p] = phi[p]*pi/180.0;
+    ProbeArray points(Np,z,r,phi_rad,mesh_coords,dims,stopmsg);
+    int *nodes = points.Nodes(Nnodes);
+
+    // Cycles held by every selected variable:
+    for(int m=0; m<nvars; m++) {
+        if(data_objs[m] == NULL)
+            continue;
+        if(first == NULL)
+            first = data_objs[m];
+        if(data_objs[m]->Ncyc < Ncyc)
+            Ncyc = data_objs[m]->Ncyc;
+        Nvals += (m < 2) ? 1 : ndims;
+    }
+    if(first == NULL) {
+        char message[1001];
+        sprintf(message,"      %s\n      %s",
+                "No variables were selected by the data flags.",stopmsg);
+        StopExecution(message);
+    }
+    if(last_cycle == 0 || last_cycle > Ncyc)
+        last_cycle = Ncyc;
+
+    // Header of the history file:
+    ofstream file;
+    OpenOutputFile(file,out_path,history_name,stopmsg);
+    file << "# Points= " << Np << endl;
+    for(int p=0; p<Np; p++) {
+        sprintf(outstr,"# %5d  %13.6E  %13.6E  %10.4f\n",p+1,z[p],r[p],phi[p]);
+        file << outstr;
+    }
+    file << "# cycle  time  (";
+    for(int m=0; m<nvars; m++) {
+        if(data_objs[m] == NULL)
+            continue;
+        char vchar = data_objs[m]->vchar;
+        if(m < 2)
+            sprintf(outstr," %c",vchar);
+        else
+            sprintf(outstr," %c_z %c_r %c_phi",vchar,vchar,vchar);
+        file << outstr;
+    }
+    file << " ) at each point" << endl;
+
+    // Gather the nodes of each cycle:
+    float *node_vals[ndims], *vals = new float[Nvals*Np];
+    for(int c=0; c<ndims; c++)
+        node_vals[c] = new float[Nnodes];
+    int Nwritten = 0;
+    for(int cycle=first_cycle; cycle<=last_cycle; cycle++) {
+        bool valid = true;
+        for(int m=0; m<nvars; m++) {
+            if(data_objs[m] != NULL && !data_objs[m]->cycle_mask[cycle-1])
+                valid = false;
+        }
+        if(!valid)
+            continue;
+
+        StageTimer::Set_Cycle(cycle);
+        int v = 0;
+        for(int m=0; m<nvars; m++) {
+            if(data_objs[m] == NULL)
+                continue;
+            int ncomp = (m < 2) ? 1 : ndims;
+            data_objs[m]->ReadPoints_Binary(cycle,Nnodes,nodes,node_vals);
+            for(int c=0; c<ncomp; c++, v++)
+                points.Apply(node_vals[c],vals+v*Np);
+        }
+
+        sprintf(outstr,"%6d  %13.6E",cycle,first->times[cycle-1]);
+        file << outstr;
+        for(int p=0; p<Np; p++) {
+            for(v=0; v<Nvals; v++) {
+                sprintf(outstr,"  %13.6E",vals[v*Np+p]);
+                file << outstr;
+            }
+        }
+        file << endl;
+        Nwritten++;
+    }
+    StageTimer::Set_Cycle(0);
+    file.close();
+
+    for(int c=0; c<ndims; c++)
+        delete [] node_vals[c];
+    delete [] vals;
+    delete [] z;
+    delete [] r;
+    delete [] phi;
+    delete [] phi_rad;
+
+    cout << "    Cycles: " << Nwritten << endl;
+    cout << "    Output: \"" << out_path << history_name << "\"\n";
+}
+
+//============================================================================//
+//============================================================================//
@@ -4,7 +4,7 @@
 Clayton Myers
 HYM_SILO.cpp
 Created:  18 June 2009
-Modified: 06 February 2010
+Modified: 17 October 2026
 
 This is the parent routine to the HYM-to-SILO conversion routine.  It accesses 
 the raw binary output from HYM and converts one or all of the output cycles to
@@ -26,6 +26,74 @@ Present data_flags key: (Length = 5)
     #3 = B (magnetic field)
     #4 = v (fluid velocity)
     #5 = J (current density)
+
+Optional arguments (after the four required arguments):
+    --mmap     -- Read the binary records through a memory map of each source
+                  file instead of through positional (pread) reads.
+    --huge-pages -- Back the recycled per-cycle buffers (records, ghosted
+                  arrays and blocks) with transparent huge pages.
+    --follow   -- Keep running after the available cycles are converted and
+                  convert new cycles as HYM appends them to the source files.
+                  Conversion starts from the requested cycle (or cycle 1 if
+                  cycle = 0) and runs until interrupted (Ctrl-C).
+    --poll=N   -- Polling interval in seconds for --follow (default 5).  New
+                  data is picked up immediately when inotify is available,
+                  but the poll also catches writes from other hosts.
+    --pipeline[=D] -- Overlap the binary reads, transforms and SILO writes of
+                  consecutive cycles on separate threads.  D is the number of
+                  cycles queued between stages (default 2).
+    -j N       -- Convert up to N independent cycles at once on a pool of 
+                  worker threads (implies --pipeline).  Reads and transforms
+                  run concurrently; the SILO writes are serialized.
+    -t N       -- Use up to N threads within each cycle (default 1).  The 
+                  variables are read and transformed concurrently and the 
+                  stripping, ghost-zone and coordinate kernels are split into
+                  phi slabs.  With -j, the N threads are shared between the
+                  workers.
+    --shared-mesh -- Write the mesh once to HYM_mesh.silo in silo_path.  Each
+                  cycle database then refers to it through a multimesh and 
+                  holds its variables in the "data" directory, with a 
+                  multivar of the usual name for each variable.
+    --cyl      -- Write a collinear (z,r,phi) mesh with the cylindrical 
+                  coordinate system option instead of the full Cartesian 
+                  coordinate arrays, and keep the vectors in their native 
+                  (z,r,phi) components (e.g. B_z, B_r, B_phi).  The mesh is 
+                  then a few coordinate vectors instead of three 3D arrays.
+    --hdf5     -- Write the databases with the HDF5 driver instead of PDB.
+    --compress=SPEC -- Compress the HDF5 databases (implies --hdf5).  SPEC is
+                  a SILO compression string, e.g. "METHOD=GZIP LEVEL=6", 
+                  "METHOD=SZIP" or the lossy/lossless "METHOD=FPZIP LOSS=16".
+                  The SILO HDF5 driver stores each array as a single chunk.
+    --series   -- Write all cycles into the single container HYM_series.silo
+                  in silo_path, with a directory per cycle (HYM_001, ...) 
+                  holding what HYM_001.silo would hold and a root time table
+                  ("cycles" and "times") rewritten after every cycle.  A 
+                  later run extends an existing container and keeps the 
+                  cycles it already holds.  The SILO readers open the 
+                  container once for the whole series when the per-cycle 
+                  files are absent.
+    --blocks=QxS -- Split each cycle into Q blocks in z and S blocks in phi,
+                  written to the directories block_0, block_1, ... with a 
+                  multimesh and a multivar for each variable so that VisIt 
+                  can load the blocks in parallel.  Neighbouring blocks share
+                  their boundary nodes and only the outer phi blocks carry 
+                  the phi ghost planes.
+    --max-mem=MB -- Low-memory mode for meshes too large to hold whole: each
+                  cycle is streamed as blocks (as with --blocks) that are 
+                  read from the binary files, transformed and written one at
+                  a time.  The phi (then z) blocks are refined from the 
+                  --blocks layout until a block of one variable fits in MB 
+                  megabytes, which bounds the memory of the data to about MB
+                  (plus the stripped mesh vectors).
+    --bench    -- Write the requested cycle (cycle >= 1) once with each of 
+                  PDB, HDF5, HDF5 + GZIP and HDF5 + FPZIP (plus the --compress
+                  setting if given) into bench_<driver>/ directories under 
+                  silo_path and report the write time, throughput and size.
+    --timing   -- Time each stage (indexing, binary reads, ghost stripping,
+                  ghost planes, Cartesian transform, zero threshold, DBPut*,
+                  DBClose) of every cycle and write the calls, seconds, bytes
+                  and MB/s of each, with their totals and the cycles per 
+                  second, to HYM_timing.json and HYM_timing.csv in silo_path.
                       
 */
 //============================================================================//
@@ -35,19 +103,55 @@ Present data_flags key: (Length = 5)
 #include <HYM_DataObj.hpp>
 #include <SILO_CycObj.hpp>
 #include <SILO_Write.hpp>
+#include <SILO_Pipeline.hpp>
+#include <Thread_Functions.hpp>
+#include <Buffer_Pool.hpp>
+#include <Stage_Timers.hpp>
+
+#include <signal.h>
+#include <sys/select.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
 
 //============================================================================//
 //============================================================================//
 void ReadArgs(int,char**,char*&,char*&,int&,bool*);
+void ReadOptions(int,char**,int);
 void ReadStatData(char*,int&,int*);
 void Unify_Ncyc(HYMDataObj**,int&);
 void Write_Report(int Ncyc,SILO_CycObj**,char*);
 void CleanUp(int,float**,HYMDataObj**,SILO_CycObj**);
+void Convert_Cycles(SILO_CycObj**,int,char*);
+void Follow_Run(int,char*,char*,int*,float**,HYMDataObj**,bool*);
+int Settled_Ncyc(HYMDataObj**);
+int Watch_DataPath(char*);
+void Wait_For_Data(int,HYMDataObj**);
+void Stop_Follow(int);
+void Limit_Blocks(int*);
+void Fit_Blocks(int*);
+long Block_Bytes(int*);
+void Bench_Drivers(SILO_CycObj*,char*);
+double Wall_Time(void);
 
 char *fname_mesh = "hgrid.d";
 char *fname_stat = "hstat.d";
 char *stopmsg = "Stopping SILO File Construction.";
 
+bool follow_flag = false;           // Convert new cycles as they are written
+int poll_interval = 5;              // Seconds between checks in follow mode
+int pipeline_depth = 0;             // Queue depth of the pipeline (0 = serial)
+int num_workers = 1;                // Number of cycle conversion workers
+bool bench_flag = false;            // Compare the SILO drivers on one cycle
+char *compress_spec = NULL;         // SILO compression string (HDF5 only)
+volatile sig_atomic_t stop_follow = 0;
+
+// Peak bytes per node of a streamed block (a vector block in float and the 
+// double buffer of one component read, see HYMDataObj::ReadBlock_Binary):
+const long stream_bytes = 3*sizeof(float) + sizeof(double);
+
 //============================================================================//
 int main(int argc, char *argv[]) {
     int cycle, Ncyc, dims[ndims];
@@ -60,6 +164,8 @@ int main(int argc, char *argv[]) {
     ReadArgs(argc,argv,data_path,silo_path,cycle,data_flags);
     ReadStatData(data_path,Ncyc,dims);
     HYMDataObj::ReadMesh_Binary(data_path,fname_mesh,dims,mesh_coords,stopmsg);
+    Limit_Blocks(dims);
+    Fit_Blocks(dims);
     
     // Define and initialize the HYM data objects:
     HYMDataObj *data_objs[nvars];
@@ -81,6 +187,15 @@ int main(int argc, char *argv[]) {
     // Unify the Ncyc value and the time series:
     Unify_Ncyc(data_objs,Ncyc);
     
+    // In follow mode, convert cycles as they are completed until interrupted:
+    if(follow_flag) {
+        Follow_Run(cycle,data_path,silo_path,dims,mesh_coords,data_objs,
+                   data_flags);
+        CleanUp(0,mesh_coords,data_objs,NULL);
+        StageTimer::Write_Report(silo_path,"HYM_timing",stopmsg);
+        return 0;
+    }
+    
     // Define and initialize the SILO cycle objects:
     SILO_CycObj *cyc_objs[Ncyc];
     for(int m=0; m<Ncyc; m++)
@@ -106,22 +221,37 @@ int main(int argc, char *argv[]) {
         StopExecution(message);
     }
 
+    // Compare the SILO drivers on the requested cycle:
+    if(bench_flag) {
+        if(cycle == 0) {
+            CleanUp(Ncyc,mesh_coords,data_objs,cyc_objs);
+            char message[1001];
+            sprintf(message,"      %s\n      %s",
+                    "The --bench option requires a single cycle (cycle >= 1).",
+                    stopmsg);
+            StopExecution(message);
+        }
+        Bench_Drivers(cyc_objs[cycle-1],silo_path);
+        CleanUp(Ncyc,mesh_coords,data_objs,cyc_objs);
+        StageTimer::Write_Report(silo_path,"HYM_timing",stopmsg);
+        return 0;
+    }
+
     // Write the SILO databases:
+    Convert_Cycles(cyc_objs,Ncyc,silo_path);
     report_flag = false;  
     for(int m=0; m<Ncyc; m++) {
-        if(cyc_objs[m] != NULL) {
-            cyc_objs[m]->Write_SILO(silo_path);
-            if(cyc_objs[m]->report_flag)
-                report_flag = true;   
-        }
+        if(cyc_objs[m] != NULL && cyc_objs[m]->report_flag)
+            report_flag = true;   
     }
     
     // Write a report if abnormalities exist:
     if(report_flag)
         Write_Report(Ncyc,cyc_objs,silo_path);    
 
-    // Clean up the allocated arrays:
+    // Clean up the allocated arrays and write the stage timings:
     CleanUp(Ncyc,mesh_coords,data_objs,cyc_objs);
+    StageTimer::Write_Report(silo_path,"HYM_timing",stopmsg);
 }
 
 //============================================================================//
@@ -131,7 +261,7 @@ void ReadArgs(int argc, char **argv, char *&data_path, char *&silo_path,
     char message[1001];
               
     // Count the initial command line arguments
-    if(!(argc == 5)) {
+    if(argc < 5) {
         sprintf(message,"      %s%s\n      %s","An improper number of ",
                 "command line arguments was found.",stopmsg);
         StopExecution(message);
@@ -166,6 +296,125 @@ void ReadArgs(int argc, char **argv, char *&data_path, char *&silo_path,
             StopExecution(message);
         }
     }
+    
+    // Process any optional arguments:
+    ReadOptions(argc,argv,5);
+    SetDriver_SILO(silo_driver,compress_spec);
+}
+
+//============================================================================//
+void ReadOptions(int argc, char **argv, int first) {
+    // Processes the optional command line arguments starting at argv[first]
+    for(int m=first; m<argc; m++) {
+        if(strcmp(argv[m],"--mmap") == 0)
+            HYMDataObj::use_mmap = true;
+        else if(strcmp(argv[m],"--huge-pages") == 0)
+            BufferPool::huge_pages = true;
+        else if(strcmp(argv[m],"--timing") == 0)
+            StageTimer::Start();
+        else if(strcmp(argv[m],"--cyl") == 0)
+            cyl_output = true;
+        else if(strcmp(argv[m],"--hdf5") == 0)
+            silo_driver = DB_HDF5;
+        else if(strncmp(argv[m],"--compress=",11) == 0)
+            compress_spec = argv[m]+11;
+        else if(strncmp(argv[m],"--blocks=",9) == 0) {
+            if(sscanf(argv[m]+9,"%dx%d",&Nblocks_q,&Nblocks_s) != 2 ||
+               Nblocks_q < 1 || Nblocks_s < 1) {
+                char message[1001];
+                sprintf(message,"      %s\"%s\"%s\n      %s",
+                        "The block layout ",argv[m]+9," is not valid (QxS).",
+                        stopmsg);
+                StopExecution(message);
+            }
+        }
+        else if(strncmp(argv[m],"--max-mem=",10) == 0) {
+            int budget_mb;
+            ConvertToInt(argv[m]+10,budget_mb,stopmsg);
+            if(budget_mb < 1)
+                budget_mb = 1;
+            SILO_CycObj::mem_budget = (long)budget_mb*1024*1024;
+        }
+        else if(strcmp(argv[m],"--series") == 0)
+            SILO_CycObj::series = true;
+        else if(strcmp(argv[m],"--bench") == 0)
+            bench_flag = true;
+        else if(strcmp(argv[m],"--shared-mesh") == 0)
+            SILO_CycObj::shared_mesh = true;
+        else if(strcmp(argv[m],"--follow") == 0)
+            follow_flag = true;
+        else if(strcmp(argv[m],"--pipeline") == 0)
+            pipeline_depth = 2;
+        else if(strncmp(argv[m],"--pipeline=",11) == 0) {
+            ConvertToInt(argv[m]+11,pipeline_depth,stopmsg);
+            if(pipeline_depth < 1)
+                pipeline_depth = 1;
+        }
+        else if(strcmp(argv[m],"-j") == 0 && m+1 < argc) {
+            ConvertToInt(argv[m+1],num_workers,stopmsg);
+            if(num_workers < 1)
+                num_workers = 1;
+            m++;
+        }
+        else if(strcmp(argv[m],"-t") == 0 && m+1 < argc) {
+            ConvertToInt(argv[m+1],Nthreads,stopmsg);
+            if(Nthreads < 1)
+                Nthreads = 1;
+            m++;
+        }
+        else if(strncmp(argv[m],"--poll=",7) == 0) {
+            ConvertToInt(argv[m]+7,poll_interval,stopmsg);
+            if(poll_interval < 1)
+                poll_interval = 1;
+        }
+        else {
+            char message[1001];
+            sprintf(message,"      %s\"%s\"%s\n      %s",
+                    "The optional argument ",argv[m]," is not recognized.",
+                    stopmsg);
+            StopExecution(message);
+        }
+    }
+}
+
+//============================================================================//
+void Limit_Blocks(int *dims) {
+    // Keeps at least one zone in each block (see --blocks)
+    if(Nblocks_q > dims[0]-1)
+        Nblocks_q = (dims[0] > 1) ? dims[0]-1 : 1;
+    if(Nblocks_s > dims[2]+2*Nghost)
+        Nblocks_s = dims[2]+2*Nghost;
+}
+
+//============================================================================//
+void Fit_Blocks(int *dims) {
+    // Refines the block layout of the low-memory mode (see --max-mem) in phi
+    // and then in z until the largest block fits in the memory budget
+    long budget = SILO_CycObj::mem_budget;
+    if(budget <= 0)
+        return;
+    int Ns_g = dims[2] + 2*Nghost + 1;
+    while(Block_Bytes(dims) > budget && Nblocks_s < Ns_g-1)
+        Nblocks_s++;
+    while(Block_Bytes(dims) > budget && Nblocks_q < dims[0]-1)
+        Nblocks_q++;
+    
+    char outstr[1001];
+    sprintf(outstr,"      Low-memory mode: %dx%d blocks of up to %.1f MB\n",
+            Nblocks_q,Nblocks_s,Block_Bytes(dims)/(1024.*1024.));
+    cout << outstr;
+    if(Block_Bytes(dims) > budget)
+        cout << "      (the budget is smaller than the finest block layout)\n";
+}
+
+//============================================================================//
+long Block_Bytes(int *dims) {
+    // Peak bytes of the largest block of the present layout (see 
+    // BlockIndex_SILO; neighbouring blocks share their boundary nodes)
+    int Ns_g = dims[2] + 2*Nghost + 1;
+    long Nq = (dims[0]-1 + Nblocks_q-1)/Nblocks_q + 1;
+    long Ns = (Ns_g-1 + Nblocks_s-1)/Nblocks_s + 1;
+    return stream_bytes*Nq*dims[1]*Ns;
 }
 
 //============================================================================//
@@ -269,6 +518,8 @@ void Write_Report(int Ncyc, SILO_CycObj **cyc_objs, char *silo_path) {
 
 //============================================================================//
 void CleanUp(int Ncyc, float **mcoords, HYMDataObj **dobj, SILO_CycObj **cobj) {
+    SILO_CycObj::Close_Series();
+    SILO_CycObj::Free_Mesh();
     for(int m=0; m<ndims; m++)
         delete [] mcoords[m];
     for(int m=0; m<nvars; m++) {
@@ -279,6 +530,232 @@ void CleanUp(int Ncyc, float **mcoords, HYMDataObj **dobj, SILO_CycObj **cobj) {
         if(cobj[m] != NULL)
             delete cobj[m];
     }
+    BufferPool::Release();
+}
+
+//============================================================================//
+//============================================================================//
+void Convert_Cycles(SILO_CycObj **cyc_objs, int Ncyc, char *silo_path) {
+    // Writes the SILO database of each (non-NULL) cycle object, either one 
+    // cycle at a time or through the staged conversion pipeline.
+    if(num_workers > 1) {
+        int depth = (pipeline_depth > 0) ? pipeline_depth : num_workers;
+        Run_Pipeline(cyc_objs,Ncyc,silo_path,depth,num_workers);
+        return;
+    }
+    if(pipeline_depth > 0) {
+        Run_Pipeline(cyc_objs,Ncyc,silo_path,pipeline_depth,1);
+        return;
+    }
+    for(int m=0; m<Ncyc; m++) {
+        if(cyc_objs[m] != NULL)
+            cyc_objs[m]->Write_SILO(silo_path);
+    }
+}
+
+//============================================================================//
+void Follow_Run(int cycle, char *data_path, char *silo_path, int *dims,
+                float **mesh_coords, HYMDataObj **data_objs, bool *data_flags) {
+    // Converts each cycle once its record is complete in every source file,
+    // then waits for HYM to append more records.  Only the new cycles are 
+    // validated and converted on each pass.
+    int next_cycle, Nsettled, Nnew, notify_fd;
+    bool found = false;
+    
+    for(int m=0; m<nvars; m++) {
+        if(data_objs[m] != NULL)
+            found = true;
+    }
+    if(!found || cycle < 0) {
+        char message[1001];
+        sprintf(message,"      %s\n      %s",
+                "Follow mode requires at least one variable and cycle >= 0.",
+                stopmsg);
+        StopExecution(message);
+    }
+    
+    next_cycle = (cycle > 0) ? cycle : 1;
+    notify_fd = Watch_DataPath(data_path);
+    signal(SIGINT,Stop_Follow);
+    signal(SIGTERM,Stop_Follow);
+    cout << "      Following: " << data_path << " (interrupt to stop)\n";
+    
+    while(!stop_follow) {
+        // Convert every newly completed cycle:
+        Nsettled = Settled_Ncyc(data_objs);
+        Nnew = Nsettled - next_cycle + 1;
+        if(Nnew > 0) {
+            SILO_CycObj **cyc_objs = new SILO_CycObj*[Nnew];
+            for(int m=0; m<Nnew; m++)
+                cyc_objs[m] = new SILO_CycObj(next_cycle+m,mesh_coords,dims,
+                                              data_objs,data_flags,stopmsg);
+            Convert_Cycles(cyc_objs,Nnew,silo_path);
+            for(int m=0; m<Nnew; m++) {
+                if(cyc_objs[m]->report_flag) {
+                    cout << "      Warning: Cycle " << cyc_objs[m]->cycle;
+                    cout << " converted with status \"";
+                    cout << cyc_objs[m]->stat_str << "\".\n";
+                }
+                delete cyc_objs[m];
+            }
+            delete [] cyc_objs;
+            next_cycle = Nsettled + 1;
+        }
+        if(stop_follow)
+            break;
+        
+        // Wait for more data and re-validate any source file that grew:
+        Wait_For_Data(notify_fd,data_objs);
+        for(int m=0; m<nvars; m++) {
+            if(data_objs[m] != NULL)
+                data_objs[m]->Refresh();
+        }
+    }
+    
+    if(notify_fd >= 0)
+        close(notify_fd);
+    cout << "      Stopped following after cycle " << next_cycle-1 << ".\n";
+}
+
+//============================================================================//
+int Settled_Ncyc(HYMDataObj **data_objs) {
+    // Returns the number of cycles whose records are complete in all of the
+    // source files (a partially written record is not yet settled).
+    int Nsettled = -1;
+    for(int m=0; m<nvars; m++) {
+        if(data_objs[m] != NULL) {
+            if(Nsettled < 0 || data_objs[m]->Ncomplete < Nsettled)
+                Nsettled = data_objs[m]->Ncomplete;
+        }
+    }
+    return (Nsettled < 0) ? 0 : Nsettled;
+}
+
+//============================================================================//
+int Watch_DataPath(char *data_path) {
+    // Sets up an inotify watch on the data directory.  Returns -1 if inotify
+    // is not available, in which case follow mode simply polls.
+    int notify_fd = -1;
+#ifdef __linux__
+    notify_fd = inotify_init();
+    if(notify_fd >= 0) {
+        if(inotify_add_watch(notify_fd,data_path,
+                             IN_MODIFY|IN_CLOSE_WRITE|IN_MOVED_TO) < 0) {
+            close(notify_fd);
+            notify_fd = -1;
+        }
+    }
+#endif
+    if(notify_fd < 0) {
+        cout << "      Warning: inotify is unavailable; polling every ";
+        cout << poll_interval << " s.\n";
+    }
+    return notify_fd;
+}
+
+//============================================================================//
+void Wait_For_Data(int notify_fd, HYMDataObj **data_objs) {
+    // Blocks until one of the source files changes or the poll interval 
+    // expires.  Other changes to the data directory (such as the .idx files 
+    // written by this program) do not end the wait.
+    if(notify_fd < 0) {
+        sleep(poll_interval);
+        return;
+    }
+#ifdef __linux__
+    fd_set read_set;
+    struct timeval timeout;
+    double remaining, deadline = Wall_Time() + poll_interval;
+    char buffer[4096] __attribute__((aligned(8)));
+    struct inotify_event *event;
+    long length, pos;
+    
+    while(!stop_follow && (remaining = deadline - Wall_Time()) > 0.0) {
+        FD_ZERO(&read_set);
+        FD_SET(notify_fd,&read_set);
+        timeout.tv_sec = (long)remaining;
+        timeout.tv_usec = (long)(1.0e6*(remaining - timeout.tv_sec));
+        if(select(notify_fd+1,&read_set,NULL,NULL,&timeout) <= 0)
+            return;
+        length = read(notify_fd,buffer,sizeof(buffer));
+        if(length <= 0)
+            return;
+        for(pos=0; pos<length; pos+=sizeof(struct inotify_event)+event->len) {
+            event = (struct inotify_event*)(buffer+pos);
+            if(event->len == 0)
+                continue;
+            for(int m=0; m<nvars; m++) {
+                if(data_objs[m] != NULL && 
+                   data_objs[m]->IsSourceFile(event->name))
+                    return;
+            }
+        }
+    }
+#endif
+}
+
+//============================================================================//
+void Stop_Follow(int) {
+    stop_follow = 1;
+}
+
+//============================================================================//
+void Bench_Drivers(SILO_CycObj *cyc_obj, char *silo_path) {
+    // Writes one cycle with each SILO driver and compression setting and 
+    // reports the write time, throughput and file size.  The binary reads and
+    // transforms are repeated for each setting but are not timed.
+    const int Nbench = 5;
+    char *names[Nbench] = {"pdb","hdf5","gzip","fpzip","custom"};
+    int drivers[Nbench] = {DB_PDB,DB_HDF5,DB_HDF5,DB_HDF5,DB_HDF5};
+    char *specs[Nbench] = {NULL,NULL,"METHOD=GZIP LEVEL=6","METHOD=FPZIP",
+                           compress_spec};
+    char bench_path[1001], full_name[1001], outstr[1001];
+    double t1, t2, size, size_pdb = 0.0;
+    int driver = silo_driver;
+    struct stat fstats;
+    
+    if(cyc_obj == NULL || !cyc_obj->write_flag) {
+        cout << "      No data to benchmark for this cycle.\n";
+        return;
+    }
+    
+    // Each setting gets its own file (no time-series container):
+    SILO_CycObj::series = false;
+    
+    cout << "\n      Driver      Write (s)    MB/s    Size (MB)   Ratio\n";
+    for(int m=0; m<Nbench; m++) {
+        if(m == Nbench-1 && compress_spec == NULL)
+            break;
+        sprintf(bench_path,"%sbench_%s/",silo_path,names[m]);
+        mkdir(bench_path,0755);
+        SetDriver_SILO(drivers[m],specs[m]);
+        
+        // Write the mesh file into each directory (shared mesh mode):
+        SILO_CycObj::Free_Mesh();
+        cyc_obj->Read_Data();
+        cyc_obj->Transform_Data();
+        t1 = Wall_Time();
+        cyc_obj->Put_SILO(bench_path);
+        t2 = Wall_Time();
+        
+        sprintf(full_name,"%sHYM_%0.3d.silo",bench_path,cyc_obj->cycle);
+        size = (stat(full_name,&fstats) == 0) ? (double)fstats.st_size : 0.0;
+        if(m == 0)
+            size_pdb = size;
+        sprintf(outstr,"      %-8s %10.3f %9.1f %10.2f %9.2f\n",names[m],t2-t1,
+                size_pdb/1.0E6/(t2-t1),size/1.0E6,
+                (size > 0.0) ? size_pdb/size : 0.0);
+        cout << outstr;
+    }
+    cout << "      (MB/s is the uncompressed PDB size over the write time)\n\n";
+    SetDriver_SILO(driver,compress_spec);
+}
+
+//============================================================================//
+double Wall_Time(void) {
+    struct timeval tv;
+    gettimeofday(&tv,NULL);
+    return tv.tv_sec + 1.0E-6*tv.tv_usec;
 }
 
 //============================================================================//
@@ -4,19 +4,25 @@
 Clayton Myers
 Probe_SILO.cpp
 Created:  18 August 2009
-Modified: 30 November 2009
+Modified: 17 October 2026
 
 Main function file for reading magnetics data for simulated SSX probe
-diagnostics from HYM's .silo storage format.  This program calculates the index
-coordinates in HYM that correspond to the physical locations of the magnetic
-probes in SSX.
-    
-The probe locations are given fractionally:
+diagnostics from HYM's .silo storage format.  The magnetic field is sampled at
+a set of probe positions by trilinear interpolation in (z,r,phi) on the mesh of
+the databases (phi is periodic).  The interpolation stencils are computed once
+(see ProbeArray in Interp_Functions) and only the phi planes that they use are
+transferred from each cycle.
+
+The probe positions are read from a geometry file with one probe per line:
+    z  r  phi
+where z and r are in the units of the mesh and phi is in degrees ('#' starts a
+comment line).  Without a geometry file the SSX array is used, whose locations
+are given fractionally (of the mesh extent in z and r and of a turn in phi):
     In Z: (FC Length =  12.0 in = 61.0 cm)
         East:     -21.6 cm  ->  8.9/61.0 = 0.146
         Midplane:   0.0 cm  -> 30.5/61.0 = 0.500
         West:     +21.6 cm  -> 52.1/61.0 = 0.854
-    
+
     In R: (FC Radius = 8.0 in = 20.3 cm)
         Probe 1:    1.0 in  ->   1.0/8.0 = 0.125
         Probe 2:    2.0 in  ->   2.0/8.0 = 0.250
@@ -25,123 +31,113 @@ The probe locations are given fractionally:
         Probe 8:    8.0 in  ->   8.0/8.0 = 1.000
 
     In Phi: (Could be arbitrarily rotated)
-        Angle 1:   45.0 deg ->    45/360 = 0.125
-        Angle 2:  135.0 deg ->   135/360 = 0.375
-        Angle 3:  225.0 deg ->   225/360 = 0.625
-        Angle 4:  315.0 deg ->   315/360 = 0.875
-        
-The location arrays (e.g. zLoc) contain lists of the fractional locations of the
-probes along the relevant dimension (see above).
-        
-The index arrays (e.g. zInd) contain lists of the calculated nearest indices
-to the probe locations in the mesh along the relevant dimension.
-
-The interpolation arrays (e.g. zInterp) contain lists of the fractional residual
-distance between the actual location of the probe and the integer node to which 
-it was mapped.  Thus, these values have a range of [-0.5,+0.5].  These values 
-can be used to interpolate among several nodes to get more accurate data values
-at the probe locations if desired.  A residual of zero (0.000) means that there 
-is an exact mapping between the probe location and the mesh.
-
-The radial dimension (r) requires divisibility by 8 to be residual-free and the 
-phi dimension (phi) requires divisibility by 4 to be residual-free.  These two 
-criteria are often satisfied, so only the axial (z) values need to be 
-interpolated in most cases.
-
-Dimensions of HYM mesh in (z,r,phi) format:
-  int dims[ndims] = {129,65,32};  // CoH Mesh
-  int dims[ndims] = {257,129,16}; // CounterH Mesh
-  
+        Angle 1:    0.0 deg ->     0/360 = 0.00
+        Angle 2:   90.0 deg ->    90/360 = 0.25
+        Angle 3:  180.0 deg ->   180/360 = 0.50
+        Angle 4:  270.0 deg ->   270/360 = 0.75
+
+The samples of every cycle are written to a single time-series file
+("Probes.dat" in probe_path).  Its header lists the probes (number, z, r and
+phi in degrees) and each following line holds the cycle, the time and the
+(z,r,phi) components of the field at each probe in turn.  A run for all of 
+the cycles (cycle == 0) rewrites the file; a run for a single cycle appends 
+its line to an existing file (with the same probes) or starts a new one.
+
 ----------------------------------------
 
 Command line arguments:
-    (1) silo_path (string) -- path to the location of the silo database from 
+    (1) silo_path (string) -- path to the location of the silo database from
             which the probe data is being extracted.
     (2) probe_path (string) -- path to the location of the output file for the
             extracted probe data.
-    (3) cycle (int) -- cycle number for extracted data.  If cycle == 0, data 
-            will be extracted from all available cycles.
-    (4) phi_rot (float) -- Arbitrary rotation angle (in degrees) for the 
+    (3) cycle (int) -- cycle number for extracted data.  If cycle == 0, data
+            will be extracted from all available cycles (otherwise the cycle
+            is appended to the time-series file).
+    (4) phi_rot (float) -- Arbitrary rotation angle (in degrees) for the
             extracted probe array.
-            
+    (5) probe_file (string, optional) -- full path of the probe geometry file.
+
 */
 //============================================================================//
 //============================================================================//
 
 #include <HYM_SILO.hpp>
 #include <SILO_Read.hpp>
+#include <Interp_Functions.hpp>
+
+#include <vector>      // For the probe list in Read_Probe_Geometry
 
 //============================================================================//
 //============================================================================//
-void ReadArgs(int,char**,char*&,char*&,int&,float&);
-void Write_ProbeData(int,char*,char*);
-void Map_Indices(float*,int,int,int*,float*);
-void Print_Indices(int,char*,int*,float*);
-void Reset_pLoc_Interval();
+void ReadArgs(int,char**,char*&,char*&,int&,float&,char*&);
+void Read_Probe_Geometry(char*,int&,float*&,float*&,float*&);
+void SSX_Probe_Geometry(float**,int*,int&,float*&,float*&,float*&);
+void Write_ProbeData(int*,int,char*,char*,char*,float,bool);
 
-// Number of probes in each dimension
+// Number of probes in each dimension (SSX array)
 const int zLen = 3;
 const int rLen = 8;
 const int pLen = 4;
 
-// Fractional probe locations
+// Fractional probe locations (SSX array)
 float zLoc[zLen] = {0.146,0.500,0.854};
 // float zLoc[zLen] = {0.235,0.500,0.765}; // For shifted probe locations
 float rLoc[rLen] = {0.125,0.250,0.375,0.500,0.625,0.750,0.875,1.000};
 float pLoc[pLen] = {0.00,0.25,0.50,0.75};
 
 char *silo_name = "HYM";
+char *probe_name = "Probes.dat";
 char *stopmsg = "Stopping probe data extraction.";
 
 //============================================================================//
 int main(int argc, char *argv[]) {
-    int cycle, Ncyc;
+    int cycle, Ncyc, *cycles;
+    bool found = false;
     float phi_rot;
-    char *silo_path=NULL, *probe_path=NULL;
-    
+    char *silo_path=NULL, *probe_path=NULL, *probe_file=NULL;
+
     // Read the command line arguments:
-    ReadArgs(argc,argv,silo_path,probe_path,cycle,phi_rot);
-    
-    // Rotate the phi locations by phi_rot:
-    for(int k=0; k<pLen; k++)
-        pLoc[k] += phi_rot/360.0;
-    Reset_pLoc_Interval();
-    
-    // Determine the available number of cycles:
-    // Ncyc = Get_Ncyc(silo_path,stopmsg);
-    Ncyc = 250;
+    ReadArgs(argc,argv,silo_path,probe_path,cycle,phi_rot,probe_file);
 
-    // Write (to a file) the probe data for the requested cycle argument:
-    if(cycle == 0) {
-        for(int m=1; m <= Ncyc; m++)
-            Write_ProbeData(m,silo_path,probe_path);
+    // Determine the available cycles:
+    cycles = Get_Cycles(silo_path,Ncyc,stopmsg);
+    for(int m=0; m<Ncyc; m++) {
+        if(cycles[m] == cycle)
+            found = true;
     }
-    else if(cycle >= 1 && cycle <= Ncyc)
-        Write_ProbeData(cycle,silo_path,probe_path);
-    else {            
+
+    // Write (to a file) the probe data for the requested cycle argument:
+    if(cycle == 0)
+        Write_ProbeData(cycles,Ncyc,silo_path,probe_path,probe_file,phi_rot,
+                        false);
+    else if(found)
+        Write_ProbeData(&cycle,1,silo_path,probe_path,probe_file,phi_rot,
+                        true);
+    else {
         char message[1001];
-        sprintf(message,"  %s\n      %s%d%s\n      %s%d%s\n  %s",
+        sprintf(message,"  %s\n      %s%d%s\n      %s%d%s%d%s\n  %s",
                 "Error in command line arguments:",
                 "The requested cycle number is not valid (cycle = ",cycle,").",
-                "The cycle number must be in the range [1,",Ncyc,"].",
-                stopmsg);
+                "The cycle must have a database in the range [",cycles[0],",",
+                cycles[Ncyc-1],"].",stopmsg);
         StopExecution(message);
     }
+    delete [] cycles;
 }
 
 //============================================================================//
 //============================================================================//
 void ReadArgs(int argc, char **argv, char *&silo_path, char *&probe_path,
-              int &cycle, float &phi_rot) {
+              int &cycle, float &phi_rot, char *&probe_file) {
     // Count the initial command line arguments:
-    if(!(argc == (1+4))) {
+    if(!(argc == (1+4) || argc == (1+5))) {
         char message[1001];
         sprintf(message,"  %s\n  %s",
                 "An improper number of command line arguments was found.",
                 stopmsg);
         StopExecution(message);
     }
-        
+
     // Distribute the command line arguments
     silo_path = argv[1];
     probe_path = argv[2];
@@ -149,112 +145,167 @@ void ReadArgs(int argc, char **argv, char *&silo_path, char *&probe_path,
     VerifyPath(probe_path,stopmsg);
     ConvertToInt(argv[3],cycle,stopmsg);
     ConvertToFloat(argv[4],phi_rot,stopmsg);
+    if(argc == (1+5))
+        probe_file = argv[5];
 }
 
 //============================================================================//
-void Write_ProbeData(int cycle, char *silo_path, char *probe_path) {
-    int i, j, k, n, dims[ndims];
-    float time, *b_field[ndims];
-    char full_name[1001], outstr[1001];
-    
-    // Load the magnetic field data and its dimensions
-    sprintf(full_name,"HYM_%0.3d.silo",cycle);
-    time = ReadTime_SILO(silo_path,full_name,"HYM_mesh",stopmsg);
-    ReadVector_SILO(silo_path,full_name,"b_field",b_field,dims,stopmsg);
-    
-    // Index and interpolation array initializations:
-    int zInd[zLen], rInd[rLen], pInd[pLen];
-    float zInterp[zLen], rInterp[rLen], pInterp[pLen];
-    
-    // Index mapping and printing calls:
-    Map_Indices(zLoc,zLen,dims[0]-1,zInd,zInterp);
-    Map_Indices(rLoc,rLen,dims[1]-1,rInd,rInterp);
-    Map_Indices(pLoc,pLen,dims[2],pInd,pInterp);
-    
-    // Print out the dimensions and the mapped indices:
-    // Print_Dims(dims);
-    // Print_Indices(zLen,"z",zInd,zInterp);
-    // Print_Indices(rLen,"r",rInd,rInterp);
-    // Print_Indices(pLen,"p",pInd,pInterp);
-
-    //------------------------------------------------------------------------//
-    // Hack overwrite of zInd array for gathering shifted probe data:
-    int ipr_east = 125;
-    zInd[0] = ipr_east;
-    zInd[1] = 256;
-    zInd[2] = 512-ipr_east;
-    //------------------------------------------------------------------------//
-    
-    // Write the magnetic field values at the various probe locations
-    ofstream file;
-    sprintf(full_name,"Probes_%0.3d.dat",cycle);
-    OpenOutputFile(file,probe_path,full_name,stopmsg);
-    file << "time= " << time << endl;
-    for(i=0; i<zLen; i++) {
-        for(j=0; j<rLen; j++) {
-            for(k=0; k<pLen; k++) {
-                n = fn(zInd[i],rInd[j],pInd[k],dims[0],dims[1]);
-                sprintf(outstr,"%6.2f  %5.2f  %8.6f  %13.6E  %13.6E  %13.6E\n",
-                        61.0*zLoc[i]-30.5,20.3*rLoc[j],2.0*pi*pLoc[k],
-                        b_field[0][n],b_field[1][n],b_field[2][n]);
-                file << outstr;
-            }
+void Read_Probe_Geometry(char *probe_file, int &Np, float *&z, float *&r,
+                         float *&phi) {
+    // Reads the (z,r,phi) positions of the probes from the geometry file
+    vector<float> zv, rv, pv;
+    char line[1001];
+    ifstream file;
+    OpenInputFile(file,"",probe_file,"ascii",stopmsg);
+    while(file.getline(line,1001)) {
+        float zp, rp, pp;
+        char *c = line;
+        while(*c == ' ' || *c == '\t')
+            c++;
+        if(*c == '#' || *c == '\0' || *c == '\r')
+            continue;
+        if(sscanf(c,"%f %f %f",&zp,&rp,&pp) != 3) {
+            char message[1001];
+            sprintf(message,"  %s \"%s\" %s\n    %s\n  %s",
+                    "The probe geometry file",probe_file,
+                    "has a line that is not of the form \"z r phi\":",line,
+                    stopmsg);
+            StopExecution(message);
         }
+        zv.push_back(zp);
+        rv.push_back(rp);
+        pv.push_back(pp);
     }
     file.close();
-    
-    for(int m=0; m<ndims; m++)
-        delete [] b_field[m];
-    
-    cout << "    Output: \"" << probe_path << full_name << "\"\n";
+
+    Np = (int)zv.size();
+    if(Np == 0) {
+        char message[1001];
+        sprintf(message,"  The probe geometry file \"%s\" %s\n  %s",
+                probe_file,"lists no probes.",stopmsg);
+        StopExecution(message);
+    }
+    z = new float[Np];
+    r = new float[Np];
+    phi = new float[Np];
+    for(int p=0; p<Np; p++) {
+        z[p] = zv[p];
+        r[p] = rv[p];
+        phi[p] = pv[p];
+    }
 }
 
 //============================================================================//
-void Map_Indices(float *loc, int len, int dim, int *ind, float *interp) {
-    // Find each index and interpolation mapping:
-    for(int i=0; i<len; i++) {
-        // Round to the nearest integer:
-        ind[i] = (int)(round(loc[i]*dim));
-        // Protect against using the outer shell index:
-        if(ind[i] == dim)
-            ind[i]--;
-        // Determine the fractional residual about the nearest integer for
-        // interpolation purposes (range = [-0.5,+0.5]):
-        interp[i] = loc[i]*dim - ind[i];
+void SSX_Probe_Geometry(float **coords, int *dims, int &Np, float *&z,
+                        float *&r, float *&phi) {
+    // Positions of the SSX probe array from its fractional locations over the
+    // extent of the mesh
+    float z0 = coords[0][0], z1 = coords[0][dims[0]-1];
+    float r0 = coords[1][0], r1 = coords[1][dims[1]-1];
+    Np = zLen*rLen*pLen;
+    z = new float[Np];
+    r = new float[Np];
+    phi = new float[Np];
+    int p = 0;
+    for(int i=0; i<zLen; i++) {
+        for(int j=0; j<rLen; j++) {
+            for(int k=0; k<pLen; k++) {
+                z[p] = z0 + zLoc[i]*(z1-z0);
+                r[p] = r0 + rLoc[j]*(r1-r0);
+                phi[p] = 360.0*pLoc[k];
+                p++;
+            }
+        }
     }
 }
 
 //============================================================================//
-void Print_Indices(int len, char *vname, int *ind, float *interp) {
-    // Nicely format the printing of a given index/interpolation array pairing
-    char ind_str[1001] = "", interp_str[1001] = "", dum_str1[10], dum_str2[10];
-    for(int i=0; i<len; i++) {
-        if(strcmp(ind_str,"") == 0) {
-            sprintf(dum_str1,"%6d",ind[i]);
-            sprintf(dum_str2,"%6.3f",interp[i]);
+void Write_ProbeData(int *cycles, int Ncyc, char *silo_path, char *probe_path,
+                     char *probe_file, float phi_rot, bool append) {
+    int Np, dims[ndims], mesh_dims[ndims];
+    float *z, *r, *phi, *coords[ndims], *b_field[ndims] = {NULL,NULL,NULL};
+    char full_name[1001], outstr[1001];
+
+    // Probe positions and their stencils on the mesh of the first cycle:
+    sprintf(full_name,"%s_%0.3d.silo",silo_name,cycles[0]);
+    {
+        SILO_Reader reader(silo_path,full_name,"HYM_mesh",stopmsg);
+        reader.GetMeshDims(mesh_dims);
+        reader.GetMeshCoords(coords);
+    }
+    if(probe_file != NULL)
+        Read_Probe_Geometry(probe_file,Np,z,r,phi);
+    else
+        SSX_Probe_Geometry(coords,mesh_dims,Np,z,r,phi);
+    float *phi_rad = new float[Np];
+    for(int p=0; p<Np; p++) {
+        phi[p] += phi_rot;
+        phi_rad[p] = phi[p]*pi/180.0;
+    }
+    ProbeArray probes(Np,z,r,phi_rad,coords,mesh_dims,stopmsg);
+    float *vals = new float[ndims*Np];
+
+    // Header of the time-series file (a single cycle is appended to an 
+    // existing file, whose header is kept):
+    ofstream file;
+    if(append && VerifyInputFile(probe_path,probe_name,"ascii",stopmsg)) {
+        sprintf(full_name,"%s%s",probe_path,probe_name);
+        file.open(full_name,ios::out|ios::app);
+        if(file.fail()) {
+            char message[1001];
+            sprintf(message,"  The file \"%s\" %s\n  %s",full_name,
+                    "could not be opened for appending.",stopmsg);
+            StopExecution(message);
         }
-        else {
-            sprintf(dum_str1,",%6d",ind[i]);
-            sprintf(dum_str2,",%6.3f",interp[i]);
+    }
+    else {
+        OpenOutputFile(file,probe_path,probe_name,stopmsg);
+        file << "# Probes= " << Np << endl;
+        for(int p=0; p<Np; p++) {
+            sprintf(outstr,"# %5d  %13.6E  %13.6E  %10.4f\n",p+1,z[p],r[p],
+                    phi[p]);
+            file << outstr;
         }
-        strcat(ind_str,dum_str1);
-        strcat(interp_str,dum_str2);
+        file << "# cycle  time  (b_z  b_r  b_phi) at each probe" << endl;
     }
-    printf("     %sInd = {%s}",vname,ind_str);
-    printf("\n  %sInterp = {%s}",vname,interp_str);
-    printf("\n\n");
-}
 
-//============================================================================//
-void Reset_pLoc_Interval() {
-    // Function to reset the interval of phi to [0,2*pi]
-    float phi_frac;
-    for(int k=0; k<pLen; k++) {
-        phi_frac = pLoc[k] - floor(pLoc[k]);
-        if(phi_frac < 0)
-            phi_frac = 1.0 + phi_frac;
-        pLoc[k] = phi_frac;
+    // Sample the magnetic field of each cycle (the field arrays are reused):
+    for(int m=0; m<Ncyc; m++) {
+        sprintf(full_name,"%s_%0.3d.silo",silo_name,cycles[m]);
+        SILO_Reader reader(silo_path,full_name,"HYM_mesh",stopmsg);
+        reader.ReadVectorPlanes("b_field",probes.Planes(),b_field,dims);
+        if(dims[0] != mesh_dims[0] || dims[1] != mesh_dims[1] ||
+           dims[2] != mesh_dims[2]) {
+            char message[1001];
+            sprintf(message,"  The mesh of \"%s\" %s\n  %s",full_name,
+                    "differs from that of the first cycle.",stopmsg);
+            StopExecution(message);
+        }
+        for(int c=0; c<ndims; c++)
+            probes.Sample(b_field[c],vals+c*Np);
+
+        sprintf(outstr,"%6d  %13.6E",cycles[m],reader.Time());
+        file << outstr;
+        for(int p=0; p<Np; p++) {
+            sprintf(outstr,"  %13.6E  %13.6E  %13.6E",
+                    vals[p],vals[Np+p],vals[2*Np+p]);
+            file << outstr;
+        }
+        file << endl;
     }
+    file.close();
+
+    for(int c=0; c<ndims; c++) {
+        delete [] b_field[c];
+        delete [] coords[c];
+    }
+    delete [] z;
+    delete [] r;
+    delete [] phi;
+    delete [] phi_rad;
+    delete [] vals;
+
+    cout << "    Output: \"" << probe_path << probe_name << "\"\n";
 }
 
 //============================================================================//
@@ -5,6 +5,7 @@ Clayton Myers
 SILO_mode_data_v2.cpp
 Created:  15 October 2010
           25 July 2011
+Modified: 17 October 2026
 
 Program for reading magnetics data for simulated SSX probe diagnostics from
 HYM's .silo storage format.
@@ -29,6 +30,17 @@ Command line arguments:
             extracted probe data.
     (3) cycle (int) -- cycle number for extracted data.  If cycle == 0, data 
             will be extracted from all available cycles.
+
+Optional arguments (after the required arguments):
+    -t N       -- Split the azimuthal mode decomposition over N threads (in z).
+    --bench    -- Time the batched FFT mode decomposition (Fourier_Modes) 
+                  against the per-column Fourier_Decomp on the first cycle 
+                  and report the largest difference in the n=0/1 amplitudes.
+                  The conversion to the phi-innermost layout and the mode 
+                  decomposition in that layout are timed as well.
+    --timing   -- Time the field reads and the mode decompositions of every
+                  cycle and write the calls, seconds, bytes and MB/s of each
+                  stage to Modes_timing.json and Modes_timing.csv in out_path.
             
 */
 //============================================================================//
@@ -37,45 +49,74 @@ Command line arguments:
 #include <HYM_SILO.hpp>
 #include <SILO_Read.hpp>
 #include <Integ_Functions.hpp>
+#include <Layout_Functions.hpp>
+#include <Thread_Functions.hpp>
+#include <Stage_Timers.hpp>
+
+#include <sys/time.h>
 
 //============================================================================//
 //============================================================================//
 void ReadArgs(int,char**,char*&,char*&,int&,int&);
 void Load_RCC_Data(int*,float**&);
-void Write_Mode_Data_Profiles(int,char*,char*,float**);
-float Compute_Radial_Average(int,float*);
+void Write_Mode_Data_Profiles(int,char*,char*,float**,VolumeInteg*);
+void Bench_Modes(int,char*);
+double Wall_Time(void);
 
 char *silo_name = "HYM";
 char *stopmsg = "Stopping SILO mode data profile extraction.";
 
+bool bench_flag = false;  // Compare the mode decompositions on one cycle
+
 //============================================================================//
 int main(int argc, char *argv[]) {
     int start_cyc, end_cyc, dims[ndims];
     double prev_time = -1.0, time;
     float **wm0_pol_RCC=NULL;
-    char *silo_path=NULL, *out_path=NULL, full_name[1001];
+    char *silo_path=NULL, *out_path=NULL;
     
     // Read the command line arguments:
     ReadArgs(argc,argv,silo_path,out_path,start_cyc,end_cyc);
     
-    // Read and format the RCC data for use in the energy density calculations:
-    Get_Mesh_Dims(silo_path,"HYM_001.silo","HYM_mesh",dims,stopmsg);
+    // Compare the mode decompositions instead of writing the profiles:
+    if(bench_flag) {
+        Bench_Modes(start_cyc,silo_path);
+        return 0;
+    }
+    
+    // Read and format the RCC data for use in the energy density calculations
+    // and build the radial quadrature from the mesh coordinates:
+    float *mesh_coords[ndims];
+    {
+        SILO_Reader reader(silo_path,"HYM_001.silo","HYM_mesh",stopmsg);
+        reader.GetMeshDims(dims);
+        reader.GetMeshCoords(mesh_coords);
+    }
+    VolumeInteg integ(mesh_coords,dims);
+    for(int m=0; m<ndims; m++)
+        delete [] mesh_coords[m];
     Load_RCC_Data(dims,wm0_pol_RCC);
 
-    // Write (to a file) the mode data for the requested cycle argument:
+    // Write (to a file) the mode data for the requested cycle argument (the
+    // times are scanned from the time index or the database metadata):
+    double *times = ReadTimes_SILO(silo_path,start_cyc,end_cyc,stopmsg);
     for(int cyc=start_cyc; cyc<=end_cyc; cyc++) {
-        sprintf(full_name,"HYM_%0.3d.silo",cyc);
-        time = ReadTime_SILO(silo_path,full_name,"HYM_mesh",stopmsg);
+        time = times[cyc-start_cyc];
         if(time != prev_time) {
-            Write_Mode_Data_Profiles(cyc,silo_path,out_path,wm0_pol_RCC);
+            StageTimer::Set_Cycle(cyc);
+            Write_Mode_Data_Profiles(cyc,silo_path,out_path,wm0_pol_RCC,
+                                     &integ);
             prev_time = time;
         }
     }
+    StageTimer::Set_Cycle(0);
+    delete [] times;
     
     // Clean up the RCC data array:
     for(int i=0; i<dims[0]; i++)
         delete [] wm0_pol_RCC[i];
     delete [] wm0_pol_RCC;
+    StageTimer::Write_Report(out_path,"Modes_timing",stopmsg);
 }
 
 //============================================================================//
@@ -83,7 +124,7 @@ int main(int argc, char *argv[]) {
 void ReadArgs(int argc, char **argv, char *&silo_path, char *&out_path,
               int &start_cyc, int &end_cyc) {
     // Count the initial command line arguments:
-    if(!(argc == (1+4))) {
+    if(argc < (1+4)) {
         char message[1001];
         sprintf(message,"  %s\n  %s",
                 "An improper number of command line arguments was found.",
@@ -98,6 +139,26 @@ void ReadArgs(int argc, char **argv, char *&silo_path, char *&out_path,
     VerifyPath(out_path,stopmsg);
     ConvertToInt(argv[3],start_cyc,stopmsg);
     ConvertToInt(argv[4],end_cyc,stopmsg);
+    
+    // Process the optional arguments:
+    for(int m=1+4; m<argc; m++) {
+        if(strcmp(argv[m],"-t") == 0 && m+1 < argc) {
+            ConvertToInt(argv[m+1],Nthreads,stopmsg);
+            if(Nthreads < 1)
+                Nthreads = 1;
+            m++;
+        }
+        else if(strcmp(argv[m],"--bench") == 0)
+            bench_flag = true;
+        else if(strcmp(argv[m],"--timing") == 0)
+            StageTimer::Start();
+        else {
+            char message[1001];
+            sprintf(message,"  %s\"%s\"\n  %s",
+                    "Unrecognized optional argument: ",argv[m],stopmsg);
+            StopExecution(message);
+        }
+    }
 }
 
 //============================================================================//
@@ -136,7 +197,7 @@ void Load_RCC_Data(int *dims, float **&wm0_pol_RCC) {
 
 //============================================================================//
 void Write_Mode_Data_Profiles(int cycle, char *silo_path, char *out_path,
-                              float **wm0_pol_RCC) {
+                              float **wm0_pol_RCC, VolumeInteg *integ) {
     int i, j, n, m, dims[ndims];
     float time, *b_field[ndims];
     char full_name[1001], outstr[1001];
@@ -144,26 +205,29 @@ void Write_Mode_Data_Profiles(int cycle, char *silo_path, char *out_path,
     //------------------------------------------------------------------------//
     // Load the magnetic field data and its dimensions:
     sprintf(full_name,"HYM_%0.3d.silo",cycle);
-    time = ReadTime_SILO(silo_path,full_name,"HYM_mesh",stopmsg);
-    ReadVector_SILO(silo_path,full_name,"b_field",b_field,dims,stopmsg);
+    SILO_Reader reader(silo_path,full_name,"HYM_mesh",stopmsg);
+    for(m=0; m<ndims; m++)
+        b_field[m] = NULL;
+    time = reader.Time();
+    {
+        StageTimer timer(stage_read,0);
+        reader.ReadVector("b_field",b_field,dims);
+        timer.AddBytes((long)ndims*dims[0]*dims[1]*dims[2]*sizeof(float));
+    }
     
     //------------------------------------------------------------------------//
-    // Initialize the Fourier coefficients c0 and c1:
+    // Initialize the Fourier coefficients c0 and c1 (over the z-r plane):
     float *c0[ndims], *c1[ndims];
     for(m=0; m<ndims; m++) {
-        c0[m] = new float[dims[0]*dims[1]*dims[2]];
-        c1[m] = new float[dims[0]*dims[1]*dims[2]];
+        c0[m] = new float[dims[0]*dims[1]];
+        c1[m] = new float[dims[0]*dims[1]];
     }
     
     //------------------------------------------------------------------------//
     // Compute the full z-r array of Fourier-decomposed Brms coefficients:
-    for(i=0; i<dims[0]; i++) {
-        for(j=0; j<dims[1]; j++) {
-            n = fn(i,j,0,dims[0],dims[1]);
-            for(m=0; m<ndims; m++) {
-                Fourier_Decomp(b_field,dims,i,j,m,c0[m][n],c1[m][n]);
-            }
-        }
+    for(m=0; m<ndims; m++) {
+        float *amp[2] = {c0[m],c1[m]};
+        Fourier_Modes(b_field,dims,m,2,amp,NULL,layout_fn);
     }
 
     //------------------------------------------------------------------------//
@@ -192,11 +256,11 @@ void Write_Mode_Data_Profiles(int cycle, char *silo_path, char *out_path,
             wm0_pol_rad[j] -= wm0_pol_RCC[i][j];
         }
 
-        // Compute the radial averages:
-        wm0_pol_avg = Compute_Radial_Average(Nr,wm0_pol_rad);
-        wm0_tor_avg = Compute_Radial_Average(Nr,wm0_tor_rad);
-        wm1_pol_avg = Compute_Radial_Average(Nr,wm1_pol_rad);
-        wm1_tor_avg = Compute_Radial_Average(Nr,wm1_tor_rad);
+        // Compute the (r dr) radial averages:
+        wm0_pol_avg = integ->RadialAverage(wm0_pol_rad);
+        wm0_tor_avg = integ->RadialAverage(wm0_tor_rad);
+        wm1_pol_avg = integ->RadialAverage(wm1_pol_rad);
+        wm1_tor_avg = integ->RadialAverage(wm1_tor_rad);
 
         // Write the results to the data file:
         sprintf(outstr,"%03d%8.2f",i,i*61.0/(1.*dims[0]-1)-30.5);
@@ -220,18 +284,96 @@ void Write_Mode_Data_Profiles(int cycle, char *silo_path, char *out_path,
 }
 
 //============================================================================//
-float Compute_Radial_Average(int Nr, float *wmn_rad) {
-    float rj_mid, wmn_mid, sum_wmn=0.0;
-
-    float Rc = 20.3;
-    float dr = Rc/(Nr-1.);
-
-    for (int j=1; j<Nr; j++) {
-        rj_mid = dr * (j-1/2.);
-        wmn_mid = (wmn_rad[j]+wmn_rad[j-1])/2.;
-        sum_wmn += 2.*pi*dr*rj_mid*wmn_mid;
+void Bench_Modes(int cycle, char *silo_path) {
+    // Times the batched mode decomposition against Fourier_Decomp for the
+    // magnetic field of one cycle and reports the largest n=0/1 difference
+    int dims[ndims], Nplane, n;
+    float *b_field[ndims], c0, c1, diff = 0.0, amp_max = 0.0;
+    char full_name[1001], outstr[1001];
+    double t1, t2, t3, t4, t5, t6;
+    
+    sprintf(full_name,"HYM_%0.3d.silo",cycle);
+    SILO_Reader reader(silo_path,full_name,"HYM_mesh",stopmsg);
+    for(int m=0; m<ndims; m++)
+        b_field[m] = NULL;
+    reader.ReadVector("b_field",b_field,dims);
+    Nplane = dims[0]*dims[1];
+    
+    float *amp[ndims][2];
+    for(int m=0; m<ndims; m++) {
+        amp[m][0] = new float[Nplane];
+        amp[m][1] = new float[Nplane];
+    }
+    
+    t1 = Wall_Time();
+    for(int m=0; m<ndims; m++)
+        Fourier_Modes(b_field,dims,m,2,amp[m],NULL,layout_fn);
+    t2 = Wall_Time();
+    for(int i=0; i<dims[0]; i++) {
+        for(int j=0; j<dims[1]; j++) {
+            n = fn(i,j,0,dims[0],dims[1]);
+            for(int m=0; m<ndims; m++) {
+                Fourier_Decomp(b_field,dims,i,j,m,c0,c1);
+                diff = max(diff,(float)fabs(c0-amp[m][0][n]));
+                diff = max(diff,(float)fabs(c1-amp[m][1][n]));
+                amp_max = max(amp_max,max(c0,c1));
+            }
+        }
     }
-    return sum_wmn/(pi*Rc*Rc);
+    t3 = Wall_Time();
+    
+    // Explicit conversion to the phi-innermost layout (and back):
+    float *b_phi[ndims] = {NULL,NULL,NULL}, *b_back = NULL;
+    float *amp_phi[2] = {new float[Nplane],new float[Nplane]};
+    t4 = Wall_Time();
+    for(int m=0; m<ndims; m++)
+        To_Phi_Layout(b_field[m],b_phi[m],dims);
+    t5 = Wall_Time();
+    for(int m=0; m<ndims; m++) {
+        Fourier_Modes(b_phi,dims,m,2,amp_phi,NULL,layout_phi);
+        for(n=0; n<Nplane; n++) {
+            diff = max(diff,(float)fabs(amp_phi[0][n]-amp[m][0][n]));
+            diff = max(diff,(float)fabs(amp_phi[1][n]-amp[m][1][n]));
+        }
+    }
+    t6 = Wall_Time();
+    delete [] amp_phi[0];
+    delete [] amp_phi[1];
+    From_Phi_Layout(b_phi[0],b_back,dims);
+    for(n=0; n<Nplane*dims[2]; n++)
+        diff = max(diff,(float)fabs(b_back[n]-b_field[0][n]));
+    
+    sprintf(outstr,"      Grid: %d x %d x %d, threads: %d\n",dims[0],dims[1],
+            dims[2],Nthreads);
+    cout << outstr;
+    sprintf(outstr,"      Fourier_Decomp: %10.3f s\n",t3-t2);
+    cout << outstr;
+    sprintf(outstr,"      Fourier_Modes:  %10.3f s  (speedup %.1fx)\n",t2-t1,
+            (t2 > t1) ? (t3-t2)/(t2-t1) : 0.0);
+    cout << outstr;
+    sprintf(outstr,"      To_Phi_Layout:  %10.3f s  (%.0f MB/s)\n",t5-t4,
+            ndims*2.*sizeof(float)*Nplane*dims[2]/1.0E6/max(t5-t4,1.0E-9));
+    cout << outstr;
+    sprintf(outstr,"      Fourier_Modes (phi layout): %10.3f s\n",t6-t5);
+    cout << outstr;
+    sprintf(outstr,"      Max |difference|: %.3E (max amplitude %.3E)\n",diff,
+            amp_max);
+    cout << outstr;
+    
+    delete [] b_back;
+    for(int m=0; m<ndims; m++) {
+        delete [] b_phi[m];
+        delete [] b_field[m];
+        delete [] amp[m][0];
+        delete [] amp[m][1];
+    }
+}
+
+//============================================================================//
+double Wall_Time(void) {
+    struct timeval tv;
+    gettimeofday(&tv,NULL);
+    return tv.tv_sec + 1.0E-6*tv.tv_usec;
 }
 
 //============================================================================//
@@ -0,0 +1,160 @@
+//============================================================================//
+/*
+
+Clayton Myers
+Buffer_Pool.cpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Session pool of the large per-cycle buffers of the conversion path.  Every
+cycle reads, transforms and writes arrays of the same few sizes, and handing
+them back to the allocator at the end of the cycle meant that the next cycle
+page-faulted (and zeroed) all of them again.  The pool keeps the returned
+buffers on a free list for their size class instead, so that after the first
+cycle the conversion runs without faults and at a flat resident size.
+
+Buffers that the pool did not hand out are passed on to delete [] by Put, so
+the owners of a buffer return it with Put whatever its origin.
+
+*/
+//============================================================================//
+//============================================================================//
+
+#include <HYM_SILO.hpp>
+#include <Buffer_Pool.hpp>
+#include <Thread_Functions.hpp>
+
+#include <sys/mman.h>
+
+// Arguments of the first-touch kernel:
+struct TouchArgs {
+    char *base;          // Start of the new buffer
+    long page;           // Page size in bytes
+};
+
+const long huge_page = 2L*1024*1024;  // Size class granule with huge_pages
+
+bool BufferPool::huge_pages = false;
+std::map<char*,long> BufferPool::sizes;
+std::multimap<long,char*> BufferPool::free_bufs;
+long BufferPool::held = 0;
+pthread_mutex_t BufferPool::lock = PTHREAD_MUTEX_INITIALIZER;
+
+//============================================================================//
+//============================================================================//
+float *BufferPool::Floats(long n) {
+    // Hands out a buffer of at least n floats
+    return (float*)BufferPool::Get(n*(long)sizeof(float));
+}
+
+//============================================================================//
+double *BufferPool::Doubles(long n) {
+    // Hands out a buffer of at least n doubles
+    return (double*)BufferPool::Get(n*(long)sizeof(double));
+}
+
+//============================================================================//
+void BufferPool::Put(float *buffer) {
+    // Takes back a buffer from Floats (other arrays are deleted)
+    if(buffer != NULL && !BufferPool::Return((char*)buffer))
+        delete [] buffer;
+}
+
+//============================================================================//
+void BufferPool::Put(double *buffer) {
+    // Takes back a buffer from Doubles (other arrays are deleted)
+    if(buffer != NULL && !BufferPool::Return((char*)buffer))
+        delete [] buffer;
+}
+
+//============================================================================//
+void BufferPool::Release(void) {
+    // Unmaps the free buffers (at the end of the session).  Buffers still in
+    // use stay known to the pool so that they can be returned later.
+    pthread_mutex_lock(&lock);
+    std::multimap<long,char*>::iterator it;
+    for(it=free_bufs.begin(); it!=free_bufs.end(); it++) {
+        munmap(it->second,(size_t)it->first);
+        sizes.erase(it->second);
+        held -= it->first;
+    }
+    free_bufs.clear();
+    pthread_mutex_unlock(&lock);
+}
+
+//============================================================================//
+long BufferPool::Bytes(void) {
+    // Bytes mapped by the pool (in use or free)
+    pthread_mutex_lock(&lock);
+    long nbytes = held;
+    pthread_mutex_unlock(&lock);
+    return nbytes;
+}
+
+//============================================================================//
+char *BufferPool::Get(long nbytes) {
+    // Returns a free buffer of the size class of nbytes, or maps a new one
+    long page = sysconf(_SC_PAGESIZE);
+    long granule = huge_pages ? huge_page : page;
+    long size = ((nbytes + granule - 1)/granule)*granule;
+    if(size <= 0)
+        size = granule;
+
+    pthread_mutex_lock(&lock);
+    std::multimap<long,char*>::iterator it = free_bufs.find(size);
+    if(it != free_bufs.end()) {
+        char *buffer = it->second;
+        free_bufs.erase(it);
+        pthread_mutex_unlock(&lock);
+        return buffer;
+    }
+    pthread_mutex_unlock(&lock);
+
+    void *base = mmap(NULL,(size_t)size,PROT_READ|PROT_WRITE,
+                      MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    if(base == MAP_FAILED) {
+        char message[1001];
+        sprintf(message,"      %s%ld%s\n      %s",
+                "Unable to map a buffer of ",size," bytes.",
+                "Stopping on an allocation failure.");
+        StopExecution(message);
+    }
+#ifdef MADV_HUGEPAGE
+    if(huge_pages)
+        madvise(base,(size_t)size,MADV_HUGEPAGE);
+#endif
+    // First touch from the threads of the caller (split as the phi slabs of
+    // the kernels that fill the buffer):
+    TouchArgs args = {(char*)base,page};
+    Parallel_For((int)(size/page),BufferPool::Touch_Slab,&args);
+
+    pthread_mutex_lock(&lock);
+    sizes[(char*)base] = size;
+    held += size;
+    pthread_mutex_unlock(&lock);
+    return (char*)base;
+}
+
+//============================================================================//
+bool BufferPool::Return(char *buffer) {
+    // Puts a buffer of the pool back on its free list (false if the buffer
+    // does not belong to the pool)
+    pthread_mutex_lock(&lock);
+    std::map<char*,long>::iterator it = sizes.find(buffer);
+    bool found = (it != sizes.end());
+    if(found)
+        free_bufs.insert(std::pair<long,char*>(it->second,buffer));
+    pthread_mutex_unlock(&lock);
+    return found;
+}
+
+//============================================================================//
+void BufferPool::Touch_Slab(int p1, int p2, void *arg) {
+    // Faults in the pages [p1,p2) of a new buffer
+    TouchArgs *args = (TouchArgs*)arg;
+    for(long p=p1; p<p2; p++)
+        args->base[p*args->page] = 0;
+}
+
+//============================================================================//
+//============================================================================//
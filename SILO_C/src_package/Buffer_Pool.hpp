@@ -0,0 +1,50 @@
+//============================================================================//
+/*
+
+Clayton Myers
+Buffer_Pool.hpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Header file for the session pool of the large per-cycle buffers.
+
+*/
+//============================================================================//
+//============================================================================//
+
+#include <map>
+#include <pthread.h>
+
+//============================================================================//
+// Pool of the large arrays of a conversion session (the stripped records and
+// their staging buffers, the ghosted SILO arrays and the output blocks).  The
+// arrays have the same few sizes in every cycle, so a returned buffer is kept
+// on the free list of its size class and handed out again instead of being
+// unmapped.  New buffers are anonymous mappings rounded up to whole pages
+// (or huge pages), first touched by the threads of the caller so that their
+// pages are placed next to the threads of the slab kernels.  The pool is
+// shared by all threads of the session.
+class BufferPool {
+    public:
+        static bool huge_pages;  // Back new buffers with transparent huge pages
+
+        static float *Floats(long);
+        static double *Doubles(long);
+        static void Put(float*);
+        static void Put(double*);
+        static void Release(void);
+        static long Bytes(void);
+
+    protected:
+        static char *Get(long);
+        static bool Return(char*);
+        static void Touch_Slab(int,int,void*);
+
+        static std::map<char*,long> sizes;          // Size of each buffer
+        static std::multimap<long,char*> free_bufs; // Free buffers by size
+        static long held;                           // Bytes mapped by the pool
+        static pthread_mutex_t lock;                // Guards the maps
+};
+
+//============================================================================//
+//============================================================================//
@@ -4,7 +4,7 @@
 Clayton Myers
 HYM_DataObj.cpp
 Created:  15 September 2009
-Modified: 06 February 2010
+Modified: 17 October 2026
 
 Class for HYM scalar and vector data objects.
 
@@ -14,8 +14,16 @@ Class for HYM scalar and vector data objects.
 
 #include <HYM_SILO.hpp>
 #include <HYM_DataObj.hpp>
+#include <Read_Planner.hpp>
+#include <Buffer_Pool.hpp>
+#include <Stage_Timers.hpp>
 #include <SILO_Write.hpp>
 #include <ASCII_Write.hpp>
+#include <Thread_Functions.hpp>
+
+#include <fcntl.h>     // For open
+#include <sys/mman.h>  // For mmap and madvise
+#include <sys/stat.h>  // For stat and fstat
 
 //============================================================================//
 const int intsize = sizeof(int);
@@ -31,6 +39,20 @@ const int Nghost_r2 = 2;
 const int Nghost_s1 = 2;
 const int Nghost_s2 = 2;
 
+// Reader mode flag (set from the HYM_SILO command line):
+bool HYMDataObj::use_mmap = false;
+
+// Identifier at the head of each cycle index sidecar file:
+const char index_magic[8] = {'H','Y','M','I','D','X','0','1'};
+
+// Arguments for the slab-parallel ghost stripping kernel:
+struct StripArgs {
+    const char *src;     // Raw record of doubles (with HYM ghost zones)
+    float *var;          // Stripped output array
+    int *dims_in;        // Dimensions of the raw record
+};
+void Strip_Slab(int,int,void*);
+
 //============================================================================//
 //############################################################################//
 //============================================================================//
@@ -42,7 +64,12 @@ HYMDataObj::HYMDataObj(char vchar, char *data_path, char *fname_src,
     this->vchar = vchar;
     this->stopmsg = stopmsg;
     this->cycle_mask=NULL;
+    this->cycle_dims = NULL;
+    this->Ncomplete = 0;
     this->times = NULL;
+    this->fd = -1;
+    this->map_base = NULL;
+    this->map_length = 0;
     
     // Verify the source data file:
     if(!VerifyInputFile(data_path,fname_src,"binary",stopmsg)) {
@@ -54,8 +81,19 @@ HYMDataObj::HYMDataObj(char vchar, char *data_path, char *fname_src,
         StopExecution(message);
     }
     
-    // Open the source data file:
-    OpenInputFile(this->file,data_path,this->fname_src,"binary",this->stopmsg);
+    // Open the source data file.  All reads are positional (pread or the
+    // memory map), so the descriptor has no shared seek position and the 
+    // object can be read from several threads at once:
+    char path[1001];
+    strcpy(path,data_path);
+    strcat(path,fname_src);
+    this->fd = open(path,O_RDONLY);
+    if(this->fd < 0) {
+        char message[1001];
+        sprintf(message,"      %s%s%s\n      %s",
+                "The binary file \"",path,"\" could not be opened.",stopmsg);
+        StopExecution(message);
+    }
     
     // Assign mesh and dimension attribute members:
     this->dims = dims;
@@ -78,14 +116,20 @@ HYMDataObj::HYMDataObj(char vchar, char *data_path, char *fname_src,
     
     // Validate the source data file and build the time vector:
     this->ValidateSourceFile();
-    this->GetTimes();
+    
+    // Map the source file if records are to be read from the page cache:
+    if(HYMDataObj::use_mmap)
+        this->MapSourceFile();
 }
 
 //============================================================================//
 HYMDataObj::~HYMDataObj(void) { 
-    this->file.close();
+    this->UnmapSourceFile();
+    close(this->fd);
     if(this->cycle_mask != NULL)
         delete [] this->cycle_mask;
+    if(this->cycle_dims != NULL)
+        delete [] this->cycle_dims;
     if(this->times != NULL)
         delete [] this->times;
 }
@@ -94,52 +138,95 @@ HYMDataObj::~HYMDataObj(void) {
 //============================================================================//
 void HYMDataObj::ValidateSourceFile(void) {
     // This function examines a source file to determine how many complete data
-    // cycles are stored in the file.
-    int dims1[ndims], dims2[ndims], Ncyc;
-    long file_length, cycle_pos;
-
+    // cycles are stored in the file.  Cycles already recorded in the index
+    // sidecar (see ReadIndex) are not re-scanned.  The index stage includes
+    // the reads of the cycle headers.
+    StageTimer timer(stage_index,0);
+    int dims1[ndims], Ncyc, Nknown, Nmem;
+    long file_length, file_mtime, cycle_pos;
+    bool *old_mask = this->cycle_mask;
+    int *old_dims = this->cycle_dims;
+    double *old_times = this->times;
+    
     // First determine the number of cycles that are stored from the file size:
-    this->file.seekg(0,ios::end);
-    file_length = this->file.tellg();
+    this->StatSourceFile(file_length,file_mtime);
     Ncyc = 0;
     while((Ncyc*this->record_length) < file_length)
         Ncyc++;
 
     // Determine which cycles have stored data and save the result to the
     // cycle_mask data member:        
-    if(Ncyc > 0)
-        this->cycle_mask = new bool[Ncyc];
-    else {
+    if(Ncyc <= 0) {
         char message[1001];
         sprintf(message,"  %s%s%s\n  %s\n      %s",
                 "    Error validating the binary file \"",this->fname_src,"\":",
                 "        No data is stored in the file.",stopmsg);
         StopExecution(message);
     }
+    this->cycle_mask = new bool[Ncyc];
+    this->cycle_dims = new int[Ncyc*ndims];
+    this->times = new double[Ncyc];
+    
+    // Recover the leading cycles from the index sidecar, or from the previous
+    // validation if this is a refresh of a growing file:
+    Nmem = (old_mask != NULL) ? this->Ncomplete : 0;
+    if(Nmem*this->record_length > file_length)
+        Nmem = 0;
     this->Ncyc = Ncyc;
+    this->Ncomplete = (int)(file_length/this->record_length);
+    Nknown = this->ReadIndex(file_length,file_mtime);
+    if(Nknown < Nmem) {
+        for(int m=0; m<Nmem; m++) {
+            this->cycle_mask[m] = old_mask[m];
+            this->times[m] = old_times[m];
+            for(int mm=0; mm<ndims; mm++)
+                this->cycle_dims[m*ndims+mm] = old_dims[m*ndims+mm];
+        }
+        Nknown = Nmem;
+    }
+    if(old_mask != NULL) {
+        delete [] old_mask;
+        delete [] old_dims;
+        delete [] old_times;
+    }
+    
+    // Read the mesh dimensions of the remaining cycles in one batch:
+    ReadPlan plan;
+    for(int m=Nknown; m<Ncyc; m++)
+        plan.Add(m*this->record_length+2*intsize+dblsize,ndims*intsize,
+                 (char*)&this->cycle_dims[m*ndims]);
+    timer.AddBytes(plan.Nbytes() + (long)(Ncyc-Nknown)*dblsize);
+    this->ExecutePlan(plan);
     
-    // Validate the stored data for each cycle:
-    for(int m=0; m<Ncyc; m++) {
+    // Validate the stored data for each remaining cycle:
+    for(int m=Nknown; m<Ncyc; m++) {
         bool valid = false;
         // First make sure the entire cycle is within the file length:
         cycle_pos = m*this->record_length;
         valid = cycle_pos < file_length;
         // Compare the mesh dimensions of this cycle with the global mesh
         // dimensions:
+        dims1[0] = dims1[1] = dims1[2] = 0;
         if(valid) {
-            this->ReadDims(cycle_pos+2*intsize+dblsize,dims1);
-            dims1[0] = dims1[0] - Nghost_q2 - Nghost_q1;
-            dims1[1] = dims1[1] - Nghost_r2 - Nghost_r1;
-            dims1[2] = dims1[2] - Nghost_s2 - Nghost_s1;
+            dims1[0] = this->cycle_dims[m*ndims+0] - Nghost_q2 - Nghost_q1;
+            dims1[1] = this->cycle_dims[m*ndims+1] - Nghost_r2 - Nghost_r1;
+            dims1[2] = this->cycle_dims[m*ndims+2] - Nghost_s2 - Nghost_s1;
             valid = HYMDataObj::CompareMeshDims(this->dims,dims1,
                                                 this->fname_src,this->stopmsg);
         }            
         // Check if the entire data record exists for this cycle:
         if(valid)
             valid = !((cycle_pos+this->record_length) > file_length);        
-        // Assign the cycle_mask value:
+        // Assign the cycle_mask and cycle_dims values:
         this->cycle_mask[m] = valid;
+        for(int mm=0; mm<ndims; mm++)
+            this->cycle_dims[m*ndims+mm] = dims1[mm];
     }
+    
+    // Read the remaining times and update the index sidecar:
+    this->GetTimes(Nknown);
+    if(Nknown < Ncyc)
+        this->WriteIndex(file_length,file_mtime);
 
     //------------------------------------------------------------------------//
     // Write out the validation results:
@@ -150,53 +237,304 @@ void HYMDataObj::ValidateSourceFile(void) {
 }
 
 //============================================================================//
-void HYMDataObj::ReadDims(long pos, int *dims) {
-    this->file.seekg(pos,ios::beg);
-    this->file.read((char*)&dims[0],intsize);
-    this->file.read((char*)&dims[1],intsize);
-    this->file.read((char*)&dims[2],intsize);
+bool HYMDataObj::Refresh(void) {
+    // Re-validates the source file if more complete records have been written
+    // to it since the last validation.  Returns true if the file has grown.
+    long file_length, file_mtime;
+    this->StatSourceFile(file_length,file_mtime);
+    if((int)(file_length/this->record_length) == this->Ncomplete)
+        return false;
+    this->ValidateSourceFile();
+    if(this->map_base != NULL) {
+        this->UnmapSourceFile();
+        this->MapSourceFile();
+    }
+    return true;
+}
+
+//============================================================================//
+bool HYMDataObj::IsSourceFile(char *fname) {
+    // Returns true if fname is the name of the source file of this variable
+    return (strcmp(fname,this->fname_src) == 0);
+}
+
+//============================================================================//
+void HYMDataObj::PutDataRef_SILO(DBfile *dbfile, char *dir) {
+    // Writes a multivar referring to this variable in the block directory dir
+    // (relative to the directory of the multivar)
+    char block_name[1001];
+    sprintf(block_name,"%s/%s",dir,this->varname);
+    PutVarRef_SILO(dbfile,this->varname,block_name);
+}
+
+//============================================================================//
+void HYMDataObj::PutDataBlock_SILO(DBfile *dbfile, char *mesh_name, 
+                                   float **vals, int *lo, int *hi) {
+    // Writes the node range [lo,hi) of the SILO-ready data in vals as one
+    // block of this variable
+    int gdims[ndims] = {this->dims[0],this->dims[1],this->dims[2]+2*Nghost+1};
+    int bdims[ndims];
+    float *block[ndims];
+    for(int m=0; m<ndims; m++)
+        bdims[m] = hi[m] - lo[m];
+    for(int m=0; m<this->nvals; m++)
+        ExtractBlock_SILO(vals[m],block[m],gdims,lo,hi);
+    PutQuadvar_SILO(dbfile,this->varname,mesh_name,this->nvals,
+                    this->CompNames(),block,bdims);
+    for(int m=0; m<this->nvals; m++)
+        BufferPool::Put(block[m]);
 }
 
 //============================================================================//
-void HYMDataObj::GetTimes(void) {
-    // Reads the time at each cycle into a single vector
-    this->times = new double[this->Ncyc];    
-    for(int cycle=1; cycle<=Ncyc; cycle++) { 
-        this->file.seekg((cycle-1)*this->record_length + 2*intsize,ios::beg);
-        this->file.read((char*)&this->times[cycle-1],dblsize);
+void HYMDataObj::StreamBlock_SILO(DBfile *dbfile, char *mesh_name, int cycle,
+                                  float **mesh_coords, int *lo, int *hi) {
+    // Writes the node range [lo,hi) of the SILO-ready data of a cycle as one
+    // block of this variable, reading only that block from the source file
+    // (low-memory mode).  Only the block is held, in plain arrays rather than
+    // the session pool so that the memory is given back between blocks.
+    int bdims[ndims];
+    float *block[ndims], *axis[ndims] = {NULL,NULL,NULL};
+    for(int m=0; m<ndims; m++)
+        bdims[m] = hi[m] - lo[m];
+    this->ReadBlock_Binary(cycle,lo,hi,block);
+    
+    // The on-axis average needs the j=1 rows of every phi plane:
+    if(exclude_origin && this->nvals == ndims && !cyl_output && lo[1] == 0) {
+        int alo[ndims] = {lo[0],1,0}, ahi[ndims] = {hi[0],2,this->dims[2]};
+        int adims[ndims];
+        bool comp_mask[ndims] = {false,true,true};
+        this->ReadRegion_Binary(cycle,alo,ahi,comp_mask,axis,adims);
+    }
+    TransformBlock_SILO(block,this->nvals,mesh_coords[2],this->dims,lo,hi,
+                        axis);
+    PutQuadvar_SILO(dbfile,this->varname,mesh_name,this->nvals,
+                    this->CompNames(),block,bdims);
+    for(int m=0; m<this->nvals; m++) {
+        delete [] block[m];
+        if(axis[m] != NULL)
+            delete [] axis[m];
     }
 }
 
+//============================================================================//
+void HYMDataObj::PutBlockRefs_SILO(DBfile *dbfile, int Nblocks) {
+    // Writes a multivar of the blocks of this variable (see PutDataBlock_SILO)
+    // stored in the directories block_0 ... block_<Nblocks-1>
+    char *block_names[Nblocks];
+    for(int b=0; b<Nblocks; b++) {
+        block_names[b] = new char[1001];
+        sprintf(block_names[b],"block_%d/%s",b,this->varname);
+    }
+    PutMultivar_SILO(dbfile,this->varname,Nblocks,block_names);
+    for(int b=0; b<Nblocks; b++)
+        delete [] block_names[b];
+}
+
+//============================================================================//
+char **HYMDataObj::CompNames(void) {
+    // Component names of the SILO variable (a scalar has one component)
+    return &this->varname;
+}
+
+//============================================================================//
+void HYMDataObj::ExecutePlan(ReadPlan &plan) {
+    // Executes a batch of reads from the source file (or its mapping)
+    StageTimer timer(stage_read,plan.Nbytes());
+    plan.Execute(this->fd,this->map_base,this->map_length);
+}
+
+//============================================================================//
+void HYMDataObj::GetTimes(int first) {
+    // Reads the time at each cycle (starting from index first) into a single 
+    // vector (in one batch of reads)
+    ReadPlan plan;
+    for(int cycle=first+1; cycle<=Ncyc; cycle++) { 
+        plan.Add((cycle-1)*this->record_length + 2*intsize,dblsize,
+                 (char*)&this->times[cycle-1]);
+    }
+    this->ExecutePlan(plan);
+}
+
+//============================================================================//
+void HYMDataObj::StatSourceFile(long &file_length, long &file_mtime) {
+    // Gets the size and modification time of the source file
+    char path[1001];
+    struct stat fstats;
+    strcpy(path,this->data_path);
+    strcat(path,this->fname_src);
+    if(stat(path,&fstats) != 0) {
+        char message[1001];
+        sprintf(message,"      %s%s%s\n      %s",
+                "Unable to stat the binary file \"",path,"\".",stopmsg);
+        StopExecution(message);
+    }
+    file_length = (long)fstats.st_size;
+    file_mtime = (long)fstats.st_mtime;
+}
+
+//============================================================================//
+int HYMDataObj::ReadIndex(long file_length, long file_mtime) {
+    // Loads the cycle entries from the index sidecar ("<fname_src>.idx") that
+    // are still valid for the source file and returns the number recovered.
+    // The index is keyed by the size and mtime of the source file.  If the 
+    // file has only grown, the records that were complete when the index was
+    // written are kept and the rest are re-scanned.
+    char path[1001], magic[8];
+    long idx_record_length, idx_length, idx_mtime, offset;
+    int idx_Ncyc, Nknown;
+    char valid;
+    ifstream file;
+    
+    sprintf(path,"%s%s.idx",this->data_path,this->fname_src);
+    file.open(path,ios::in|ios::binary);
+    if(file.fail())
+        return 0;
+    
+    // Check the index header against the source file:
+    file.read(magic,8);
+    file.read((char*)&idx_record_length,sizeof(long));
+    file.read((char*)&idx_length,sizeof(long));
+    file.read((char*)&idx_mtime,sizeof(long));
+    file.read((char*)&idx_Ncyc,intsize);
+    if(file.fail() || strncmp(magic,index_magic,8) != 0 || 
+       idx_record_length != this->record_length || idx_length > file_length) {
+        file.close();
+        return 0;
+    }
+    if(idx_length == file_length && idx_mtime == file_mtime)
+        Nknown = idx_Ncyc;
+    else if(idx_length < file_length)
+        Nknown = (int)(idx_length/this->record_length);
+    else
+        Nknown = 0;
+    if(Nknown > this->Ncyc)
+        Nknown = this->Ncyc;
+    
+    // Load the usable entries:
+    for(int m=0; m<Nknown; m++) {
+        file.read((char*)&offset,sizeof(long));
+        file.read((char*)&this->times[m],dblsize);
+        file.read((char*)&this->cycle_dims[m*ndims],ndims*intsize);
+        file.read(&valid,1);
+        this->cycle_mask[m] = (valid != 0);
+        if(offset != m*this->record_length)
+            Nknown = 0;
+    }
+    if(file.fail())
+        Nknown = 0;
+    file.close();
+    return Nknown;
+}
+
+//============================================================================//
+void HYMDataObj::WriteIndex(long file_length, long file_mtime) {
+    // Saves the cycle entries to the index sidecar.  The index is written to a
+    // temporary file and renamed so that concurrent readers never see a 
+    // partial index.  A read-only data path simply leaves the index stale.
+    char path[1001], tmp_path[1001], valid;
+    long offset;
+    ofstream file;
+    
+    sprintf(path,"%s%s.idx",this->data_path,this->fname_src);
+    sprintf(tmp_path,"%s.%d",path,(int)getpid());
+    file.open(tmp_path,ios::out|ios::binary);
+    if(file.fail())
+        return;
+        
+    file.write(index_magic,8);
+    file.write((char*)&this->record_length,sizeof(long));
+    file.write((char*)&file_length,sizeof(long));
+    file.write((char*)&file_mtime,sizeof(long));
+    file.write((char*)&this->Ncyc,intsize);
+    for(int m=0; m<this->Ncyc; m++) {
+        offset = m*this->record_length;
+        valid = this->cycle_mask[m] ? 1 : 0;
+        file.write((char*)&offset,sizeof(long));
+        file.write((char*)&this->times[m],dblsize);
+        file.write((char*)&this->cycle_dims[m*ndims],ndims*intsize);
+        file.write(&valid,1);
+    }
+    bool failed = file.fail();
+    file.close();
+    if(failed || rename(tmp_path,path) != 0)
+        remove(tmp_path);
+}
+
+//============================================================================//
+void HYMDataObj::MapSourceFile(void) {
+    // Maps the whole source file read-only so that records can be converted
+    // directly out of the page cache.  Falls back to pread on failure.
+    struct stat fstats;
+    if(fstat(this->fd,&fstats) != 0 || fstats.st_size == 0) {
+        cout << "      Warning: Unable to map " << this->fname_src;
+        cout << "; using positional reads.\n";
+        this->UnmapSourceFile();
+        return;
+    }
+    void *base = mmap(NULL,(size_t)fstats.st_size,PROT_READ,MAP_SHARED,
+                      this->fd,0);
+    if(base == MAP_FAILED) {
+        cout << "      Warning: Unable to map " << this->fname_src;
+        cout << "; using positional reads.\n";
+        this->UnmapSourceFile();
+        return;
+    }
+    this->map_base = (char*)base;
+    this->map_length = (long)fstats.st_size;
+    
+    // Cycles are converted in increasing order:
+    madvise(this->map_base,(size_t)this->map_length,MADV_SEQUENTIAL);
+}
+
+//============================================================================//
+void HYMDataObj::UnmapSourceFile(void) {
+    if(this->map_base != NULL)
+        munmap(this->map_base,(size_t)this->map_length);
+    this->map_base = NULL;
+    this->map_length = 0;
+}
+
 //============================================================================//
 //============================================================================//
 void HYMDataObj::ReadMesh_Binary(char *data_path, char* fname_mesh, int *dims,
                                  float **mesh_coords, char *stopmsg) {
     // This function loads the HYM mesh from a data file (3D or 2D)
-    int k, kshift, Nq, Nr, Ns, Ntot;
-    char str[1024];
-    ifstream file;
+    int Nq, Nr, Ns, in_dims[ndims];
+    char path[1001];
     
     // Open the designated file:
-    OpenInputFile(file,data_path,fname_mesh,"binary",stopmsg);
-
-    // Scroll through unneeded variables:
-    file.seekg(6*intsize,ios::beg);
+    strcpy(path,data_path);
+    strcat(path,fname_mesh);
+    int fd = open(path,O_RDONLY);
+    if(fd < 0) {
+        char message[1001];
+        sprintf(message,"      %s\n      %s%s%s\n      %s",
+        "Error in function ReadMesh_Binary.", 
+        "The file \"",path,"\" could not be found.",stopmsg);
+        StopExecution(message);        
+    }
 
-    // Get the input dimensions:
-    file.read((char*)&Nq,intsize);
-    file.read((char*)&Nr,intsize);
-    file.read((char*)&Ns,intsize);
+    // Get the input dimensions (after the unneeded variables):
+    ReadPlan::ReadAt(fd,6*intsize,(char*)in_dims,ndims*intsize);
+    Nq = in_dims[0];
+    Nr = in_dims[1];
+    Ns = in_dims[2];
     
-    // Read the mesh coordinates:
-    file.seekg(dblsize,ios::cur);
+    // Read the mesh coordinates (in one batch of reads):
+    long pos = 9*intsize + dblsize;
     double *q_buffer = new double[Nq];
     double *r_buffer = new double[Nr];
     double *s_buffer = new double[Ns];
-    file.read((char*)q_buffer,Nq*dblsize);
-    file.read((char*)r_buffer,Nr*dblsize);
-    file.read((char*)s_buffer,Ns*dblsize);
+    ReadPlan plan;
+    plan.Add(pos,Nq*dblsize,(char*)q_buffer);
+    plan.Add(pos+Nq*dblsize,Nr*dblsize,(char*)r_buffer);
+    plan.Add(pos+(Nq+Nr)*dblsize,Ns*dblsize,(char*)s_buffer);
+    {
+        StageTimer timer(stage_read,plan.Nbytes());
+        plan.Execute(fd,NULL,0);
+    }
     
-    file.close();
+    close(fd);
     
     // Strip off the HYM ghost coordinates:
     StripGhostCoords(q_buffer,mesh_coords[0],Nq,Nghost_q1,Nghost_q2);
@@ -249,7 +587,7 @@ bool HYMDataObj::CompareMeshDims(int *dims1, int *dims2, char *fname,
 
 //============================================================================//
 //============================================================================//
-void HYMDataObj::PositionPointer_Binary(int cycle) {
+long HYMDataObj::PositionPointer_Binary(int cycle) {
     // Error check for the requested cycle number:
     if(cycle < 1 || cycle > this->Ncyc) {
         char message[1001];
@@ -260,29 +598,179 @@ void HYMDataObj::PositionPointer_Binary(int cycle) {
                 stopmsg);
         StopExecution(message);
     }
-    // Move the pointer to the head of the data:
-    this->file.seekg((cycle-1)*record_length + 5*intsize + dblsize,ios::beg);
+    // Return the offset of the head of the data:
+    return (cycle-1)*record_length + 5*intsize + dblsize;
 }
 
 //============================================================================//
-void HYMDataObj::ReadVar_Binary(float *&var) {
-    // Reads a single variable from the source file (pointer must be 
-    // prepositioned by a function such as PositionPointer_Binary).
-    double *var_buffer = new double[this->Ntot_in];
-    this->file.read((char*)var_buffer,this->Ntot_in*dblsize);    
-        
-    // Strip the HYM ghost zones (in z, r, and phi) from the variable.
-    var = new float[this->Ntot];
-    int n = 0;
-    for(int k=Nghost_s1; k<(dims_in[2]-Nghost_s2); k++) {
+void HYMDataObj::ReadVar_Binary(long &pos, float *&var) {
+    // Reads a single variable from the source file starting at the byte offset
+    // pos (e.g. from PositionPointer_Binary) and advances pos past it.  The
+    // variable and the staging buffer come from the session pool (see
+    // BufferPool), and the variable is returned to it with BufferPool::Put.
+    long nbytes = (long)this->Ntot_in*dblsize;
+    var = BufferPool::Floats(this->Ntot);
+    
+    if(this->map_base != NULL && pos+nbytes <= this->map_length) {
+        // Hint the kernel to fault in this record ahead of the strip loop:
+        long page = sysconf(_SC_PAGESIZE);
+        long head = pos - pos%page;
+        {
+            StageTimer timer(stage_read,nbytes);
+            madvise(this->map_base+head,(size_t)(pos+nbytes-head),
+                    MADV_WILLNEED);
+        }
+        this->StripVar_Binary(this->map_base+pos,var);
+    }
+    else {
+        double *var_buffer = BufferPool::Doubles(this->Ntot_in);
+        ReadPlan plan;
+        plan.Add(pos,nbytes,(char*)var_buffer);
+        this->ExecutePlan(plan);
+        this->StripVar_Binary((char*)var_buffer,var);
+        BufferPool::Put(var_buffer);
+    }
+    pos += nbytes;
+}
+
+//============================================================================//
+void HYMDataObj::ReadPoints_Binary(int cycle, int Npts, int *nodes, 
+                                   float **vals) {
+    // Reads the values of every component at the stripped mesh nodes 
+    // nodes[Npts] (linear indices, see fn) of a cycle into vals[c][p] without
+    // reading the rest of the record.  The values are fetched as one batch of
+    // reads (see ReadPlan), so neighbouring values share a read.
+    long head = this->PositionPointer_Binary(cycle);
+    int Nq = this->dims[0], Nr = this->dims[1];
+    double *raw = new double[Npts*this->nvals];
+    ReadPlan plan;
+    for(int c=0; c<this->nvals; c++) {
+        for(int p=0; p<Npts; p++) {
+            int i = nodes[p]%Nq, j = (nodes[p]/Nq)%Nr, k = nodes[p]/(Nq*Nr);
+            long n = fn(Nghost_q1+i,Nghost_r1+j,Nghost_s1+k,
+                        this->dims_in[0],this->dims_in[1]);
+            plan.Add(head + ((long)c*this->Ntot_in + n)*dblsize,dblsize,
+                     (char*)&raw[c*Npts+p]);
+        }
+    }
+    this->ExecutePlan(plan);
+    for(int c=0; c<this->nvals; c++) {
+        for(int p=0; p<Npts; p++)
+            vals[c][p] = (float)raw[c*Npts+p];
+    }
+    delete [] raw;
+}
+
+//============================================================================//
+void HYMDataObj::ReadRegion_Binary(int cycle, int *lo, int *hi, 
+                                   bool *comp_mask, float **vals, int *rdims) {
+    // Reads the stripped node range [lo,hi) of a cycle into compact arrays 
+    // (z fastest, see fn) with the dimensions rdims = hi-lo.  Only the 
+    // components c with comp_mask[c] set (all if comp_mask is NULL) are read,
+    // into new arrays vals[c]; the others are set to NULL.  Only the z rows 
+    // of the region are read, as one batch (see ReadPlan).
+    int *planes = new int[this->dims[2]];
+    for(int k=0; k<this->dims[2]; k++)
+        planes[k] = k;
+    this->ReadRows_Binary(cycle,lo,hi,this->dims[2],planes,comp_mask,vals,
+                          rdims);
+    delete [] planes;
+}
+
+//============================================================================//
+void HYMDataObj::ReadBlock_Binary(int cycle, int *lo, int *hi, float **vals) {
+    // Reads the node range [lo,hi) of the ghosted SILO layout of a cycle (phi
+    // dimension dims[2]+2*Nghost+1, see AddGhostZones_Var) into new compact
+    // arrays vals[c] of the native components.  Each ghosted phi plane is
+    // read from its periodic source plane.
+    int Ns = this->dims[2], Ns_g = this->dims[2] + 2*Nghost + 1;
+    int bdims[ndims];
+    int *planes = new int[Ns_g];
+    for(int k=0; k<Ns_g; k++)
+        planes[k] = (k - Nghost + Ns) % Ns;
+    this->ReadRows_Binary(cycle,lo,hi,Ns_g,planes,NULL,vals,bdims);
+    delete [] planes;
+}
+
+//============================================================================//
+void HYMDataObj::ReadRows_Binary(int cycle, int *lo, int *hi, int Nplanes,
+                                 int *planes, bool *comp_mask, float **vals,
+                                 int *rdims) {
+    // Reads the node range [lo,hi) of a layout of Nplanes phi planes whose 
+    // plane k is the stripped source plane planes[k] (see ReadRegion_Binary
+    // and ReadBlock_Binary).  Only the z rows of the range are read, as one
+    // batch per component (see ReadPlan).
+    int limits[ndims] = {this->dims[0],this->dims[1],Nplanes};
+    for(int m=0; m<ndims; m++) {
+        if(lo[m] < 0 || hi[m] > limits[m] || lo[m] >= hi[m]) {
+            char message[1001];
+            sprintf(message,"      %s%s%s\n      %s%d%s%d%s%s%d%s\n      %s",
+                    "Error accessing the binary file \"",this->fname_src,"\":",
+                    "The region [",lo[m],",",hi[m],") is not valid in a ",
+                    "dimension of length ",limits[m],".",stopmsg);
+            StopExecution(message);
+        }
+        rdims[m] = hi[m] - lo[m];
+    }
+    long head = this->PositionPointer_Binary(cycle);
+    long Nrow = rdims[0], Nreg = (long)rdims[0]*rdims[1]*rdims[2];
+    double *raw = new double[Nreg];
+    
+    for(int c=0; c<this->nvals; c++) {
+        vals[c] = NULL;
+        if(comp_mask != NULL && !comp_mask[c])
+            continue;
+        ReadPlan plan;
+        long n = 0;
+        for(int k=lo[2]; k<hi[2]; k++) {
+            for(int j=lo[1]; j<hi[1]; j++) {
+                long row = fn(Nghost_q1+lo[0],Nghost_r1+j,Nghost_s1+planes[k],
+                              this->dims_in[0],this->dims_in[1]);
+                plan.Add(head + ((long)c*this->Ntot_in + row)*dblsize,
+                         Nrow*dblsize,(char*)(raw+n));
+                n += Nrow;
+            }
+        }
+        this->ExecutePlan(plan);
+        vals[c] = new float[Nreg];
+        for(n=0; n<Nreg; n++)
+            vals[c][n] = (float)raw[n];
+    }
+    delete [] raw;
+}
+
+//============================================================================//
+void HYMDataObj::StripVar_Binary(const char *src, float *var) {
+    // Strip the HYM ghost zones (in z, r, and phi) from a raw record of doubles
+    // and convert to float.  The phi planes are split over the threads.  (The
+    // faults of a mapped record are taken here.)
+    StageTimer timer(stage_strip,(long)this->Ntot_in*dblsize);
+    StripArgs args = {src,var,this->dims_in};
+    Parallel_For(this->dims[2],Strip_Slab,&args);
+}
+
+//============================================================================//
+void Strip_Slab(int k1, int k2, void *arg) {
+    // Strips the stripped phi planes [k1,k2).  The record offsets are not 
+    // 8-byte aligned in the file, so each value is copied out rather than 
+    // dereferenced in place.
+    StripArgs *args = (StripArgs*)arg;
+    int *dims_in = args->dims_in;
+    int Nq = dims_in[0] - Nghost_q1 - Nghost_q2;
+    int Nr = dims_in[1] - Nghost_r1 - Nghost_r2;
+    double val;
+    const char *row;
+    long n = (long)k1*Nq*Nr;
+    for(int k=Nghost_s1+k1; k<(Nghost_s1+k2); k++) {
         for(int j=Nghost_r1; j<(dims_in[1]-Nghost_r2); j++) {
+            row = args->src + (long)fn(0,j,k,dims_in[0],dims_in[1])*dblsize;
             for(int i=Nghost_q1; i<(dims_in[0]-Nghost_q2); i++) {
-                var[n] = (float)var_buffer[fn(i,j,k,dims_in[0],dims_in[1])];
+                memcpy(&val,row+i*dblsize,dblsize);
+                args->var[n] = (float)val;
                 n++;
             }
         }
     }
-    delete [] var_buffer;
 }
 
 //============================================================================//
@@ -316,7 +804,27 @@ void HYMScalarObj::WriteData_SILO(DBfile *dbfile, int cycle, char *mesh_name,
     float *var;
     this->ReadScalar_Binary(cycle,var);
     WriteScalar_SILO(dbfile,this->varname,mesh_name,var,this->dims);
-    delete [] var;
+    BufferPool::Put(var);
+}
+
+//============================================================================//
+void HYMScalarObj::ReadData_Binary(int cycle, float **vals) {
+    this->ReadScalar_Binary(cycle,vals[0]);
+}
+
+//============================================================================//
+void HYMScalarObj::TransformData_SILO(float **vals, float **mesh_coords) {
+    // Replaces the stripped data in vals with the SILO-ready data
+    float *silovar;
+    TransformScalar_SILO(vals[0],silovar,this->dims);
+    BufferPool::Put(vals[0]);
+    vals[0] = silovar;
+}
+
+//============================================================================//
+void HYMScalarObj::PutData_SILO(DBfile *dbfile, char *mesh_name, 
+                                float **vals) {
+    PutScalar_SILO(dbfile,this->varname,mesh_name,vals[0],this->dims);
 }
 
 //============================================================================//
@@ -328,13 +836,13 @@ void HYMScalarObj::WriteData_ASCII(char *ascii_path, int cycle, double tout,
     this->ReadScalar_Binary(cycle,var);
     WriteScalar_ASCII(ascii_path,fname_ascii,this->vchar,this->dims,   
                       mesh_coords,tout*cycle,var,this->stopmsg);
-    delete [] var;
+    BufferPool::Put(var);
 }
 
 //============================================================================//
 void HYMScalarObj::ReadScalar_Binary(int cycle, float *&var) {
-    this->PositionPointer_Binary(cycle);
-    this->ReadVar_Binary(var);
+    long pos = this->PositionPointer_Binary(cycle);
+    this->ReadVar_Binary(pos,var);
 }
 
 //============================================================================//
@@ -349,6 +857,9 @@ HYMVectorObj::HYMVectorObj(char vchar, char* data_path, char * fname_src,
         this->varnames[0] = "B_x"; 
         this->varnames[1] = "B_y";
         this->varnames[2] = "B_z";
+        this->cylnames[0] = "B_z";
+        this->cylnames[1] = "B_r";
+        this->cylnames[2] = "B_phi";
         this->ascii_name = "b3out";
     }
     else if(vchar == 'v') {
@@ -356,6 +867,9 @@ HYMVectorObj::HYMVectorObj(char vchar, char* data_path, char * fname_src,
         this->varnames[0] = "v_x"; 
         this->varnames[1] = "v_y";
         this->varnames[2] = "v_z";
+        this->cylnames[0] = "v_z";
+        this->cylnames[1] = "v_r";
+        this->cylnames[2] = "v_phi";
         this->ascii_name = "v3out";
     }
     else if(vchar == 'J') {
@@ -363,6 +877,9 @@ HYMVectorObj::HYMVectorObj(char vchar, char* data_path, char * fname_src,
         this->varnames[0] = "J_x"; 
         this->varnames[1] = "J_y";
         this->varnames[2] = "J_z";
+        this->cylnames[0] = "J_z";
+        this->cylnames[1] = "J_r";
+        this->cylnames[2] = "J_phi";
         this->ascii_name = "j3out";
     }
     else {
@@ -380,10 +897,39 @@ void HYMVectorObj::WriteData_SILO(DBfile *dbfile, int cycle,
                                   char *mesh_name, float **mesh_coords) {
     float *vec[ndims];
     this->ReadVector_Binary(cycle,vec);
-    WriteVector_SILO(dbfile,this->varname,mesh_name,this->varnames,vec,
+    WriteVector_SILO(dbfile,this->varname,mesh_name,this->CompNames(),vec,
                      mesh_coords[2],this->dims);
     for(int m=0; m<ndims; m++)
-        delete [] vec[m];
+        BufferPool::Put(vec[m]);
+}
+
+//============================================================================//
+void HYMVectorObj::ReadData_Binary(int cycle, float **vals) {
+    this->ReadVector_Binary(cycle,vals);
+}
+
+//============================================================================//
+void HYMVectorObj::TransformData_SILO(float **vals, float **mesh_coords) {
+    // Replaces the stripped data in vals with the SILO-ready data
+    float *silovec[ndims];
+    TransformVector_SILO(vals,silovec,mesh_coords[2],this->dims);
+    for(int m=0; m<ndims; m++) {
+        BufferPool::Put(vals[m]);
+        vals[m] = silovec[m];
+    }
+}
+
+//============================================================================//
+void HYMVectorObj::PutData_SILO(DBfile *dbfile, char *mesh_name, 
+                                float **vals) {
+    PutVector_SILO(dbfile,this->varname,mesh_name,this->CompNames(),vals,
+                   this->dims);
+}
+
+//============================================================================//
+char **HYMVectorObj::CompNames(void) {
+    // Component names for the SILO output mode (see cyl_output)
+    return cyl_output ? this->cylnames : this->varnames;
 }
 
 //============================================================================//
@@ -396,15 +942,15 @@ void HYMVectorObj::WriteData_ASCII(char *ascii_path, int cycle, double time,
     WriteVector_ASCII(ascii_path,fname_ascii,this->vchar,this->dims,   
                       mesh_coords,time,vec,this->stopmsg);
     for(int m=0; m<ndims; m++)
-        delete [] vec[m];
+        BufferPool::Put(vec[m]);
 }
 
 //============================================================================//
 void HYMVectorObj::ReadVector_Binary(int cycle, float **vec) {
-    this->PositionPointer_Binary(cycle);
-    this->ReadVar_Binary(vec[0]);
-    this->ReadVar_Binary(vec[1]);
-    this->ReadVar_Binary(vec[2]);
+    long pos = this->PositionPointer_Binary(cycle);
+    this->ReadVar_Binary(pos,vec[0]);
+    this->ReadVar_Binary(pos,vec[1]);
+    this->ReadVar_Binary(pos,vec[2]);
 }
 
 //============================================================================//
@@ -4,28 +4,35 @@
 Clayton Myers
 HYM_DataObj.hpp
 Created:  15 September 2009
-Modified: 06 February 2010
+Modified: 17 October 2026
 
 Header file for HYM scalar and vector data objects.
 
 */
 //============================================================================//
 //============================================================================//
+class ReadPlan;
+
 class HYMDataObj {
     public:
         char vchar;          // Single character name of the variable
         int Ncyc;            // Number of cycles in the source data
+        int Ncomplete;       // Number of complete records in the source file
         bool *cycle_mask;    // Mask of cycles where the data exists
         double *times;       // Vector with the simulation time for each cycle
+        static bool use_mmap; // Read records through a memory map of the file
 
     protected:
-        ifstream file;       // Source file object
+        int fd;              // Descriptor of the source file (positional reads)
+        char *map_base;      // Base address of the mapped source file
+        long map_length;     // Length of the mapped region in bytes
         char *data_path;     // Path to source data
         char *fname_src;     // Name of source file
         char *data_type;     // Type of data in source ("scalar" or "vector")
         int nvals;           // 1 for scalar, 3 for vector
         int *dims;           // Dimensions of mesh for SILO output
         int Ntot;            // Product of dims elements
+        int *cycle_dims;     // Stored mesh dimensions for each cycle
         int dims_in[ndims];  // Dimensions of source mesh (with HYM ghost zones)
         int Ntot_in;         // Product of dims_in elements
         long record_length;  // Binary record length for this data type
@@ -35,19 +42,39 @@ class HYMDataObj {
 
     public:
         HYMDataObj(char,char*,char*,int*,char*,int);
-        ~HYMDataObj(void);
+        virtual ~HYMDataObj(void);
         static void ReadMesh_Binary(char*,char*,int*,float**,char*);
+        bool Refresh(void);
+        bool IsSourceFile(char*);
+        void ReadPoints_Binary(int,int,int*,float**);
+        void ReadRegion_Binary(int,int*,int*,bool*,float**,int*);
+        void ReadBlock_Binary(int,int*,int*,float**);
         virtual void WriteData_SILO(DBfile*,int,char*,float**) = 0;
         virtual void WriteData_ASCII(char*,int,double,float**) = 0;
+        virtual void ReadData_Binary(int,float**) = 0;
+        virtual void TransformData_SILO(float**,float**) = 0;
+        virtual void PutData_SILO(DBfile*,char*,float**) = 0;
+        void PutDataRef_SILO(DBfile*,char*);
+        void PutDataBlock_SILO(DBfile*,char*,float**,int*,int*);
+        void StreamBlock_SILO(DBfile*,char*,int,float**,int*,int*);
+        void PutBlockRefs_SILO(DBfile*,int);
+        virtual char **CompNames(void);
         
     protected:
         static void StripGhostCoords(double*,float*&,int,int,int);
         static bool CompareMeshDims(int*,int*,char*,char*);
         void ValidateSourceFile(void);
-        void ReadDims(long,int*);
-        void GetTimes(void);
-        void PositionPointer_Binary(int);
-        void ReadVar_Binary(float*&);   
+        void ExecutePlan(ReadPlan&);
+        void GetTimes(int);
+        void StatSourceFile(long&,long&);
+        int ReadIndex(long,long);
+        void WriteIndex(long,long);
+        void MapSourceFile(void);
+        void UnmapSourceFile(void);
+        long PositionPointer_Binary(int);
+        void ReadVar_Binary(long&,float*&);
+        void ReadRows_Binary(int,int*,int*,int,int*,bool*,float**,int*);
+        void StripVar_Binary(const char*,float*);
 };
 
 //============================================================================//
@@ -56,6 +83,9 @@ class HYMScalarObj : public HYMDataObj {
         HYMScalarObj(char,char*,char*,int*,char*);
         void WriteData_SILO(DBfile*,int,char*,float**);
         void WriteData_ASCII(char*,int,double,float**);
+        void ReadData_Binary(int,float**);
+        void TransformData_SILO(float**,float**);
+        void PutData_SILO(DBfile*,char*,float**);
         
     protected:
         void ReadScalar_Binary(int,float*&);
@@ -65,11 +95,16 @@ class HYMScalarObj : public HYMDataObj {
 class HYMVectorObj : public HYMDataObj {
     protected:
         char *varnames[ndims];
+        char *cylnames[ndims];   // Component names for cylindrical output
 
     public:
         HYMVectorObj(char,char*,char*,int*,char*);
         void WriteData_SILO(DBfile*,int,char*,float**);
         void WriteData_ASCII(char*,int,double,float**);
+        void ReadData_Binary(int,float**);
+        void TransformData_SILO(float**,float**);
+        void PutData_SILO(DBfile*,char*,float**);
+        char **CompNames(void);
         
     protected:
         void ReadVector_Binary(int,float**);
@@ -4,6 +4,7 @@
 Clayton Myers
 Interp_Functions.cpp
 Created:  28 July 2010
+Modified: 17 October 2026
 
 Interpolation support for 1D and 2D arrays
 
@@ -12,82 +13,12 @@ Interpolation support for 1D and 2D arrays
 //============================================================================//
 
 #include <HYM_SILO.hpp>
+#include <Integ_Functions.hpp>
+#include <Layout_Functions.hpp>
+#include <Thread_Functions.hpp>
+#include <Stage_Timers.hpp>
 
-float integ_sumsquares_r(int,float**,int*,float,float);
-float integ_sumsquares_z(int,int,float**,int*,float);
-void get_diff_elems_and_volume(int*,float&,float&,float&,float&);
-
-//============================================================================//
-//============================================================================//
-float integ_sumsquares_3D(float **vec, int *dims, bool volume_avg) {
-    int k;
-    float integ, vec2_k1, vec2_k2, dz, dr, dp, V;
-    get_diff_elems_and_volume(dims,dz,dr,dp,V);
-    integ = 0.0;
-    for(k=1; k<dims[2]; k++) {
-        vec2_k1 = integ_sumsquares_r(k-1,vec,dims,dr,dz);
-        vec2_k2 = integ_sumsquares_r(k  ,vec,dims,dr,dz);
-        integ += (vec2_k1+vec2_k2)/2. * dp;
-    }
-    vec2_k1 = integ_sumsquares_r(dims[2]-1,vec,dims,dr,dz);
-    vec2_k2 = integ_sumsquares_r(0        ,vec,dims,dr,dz);
-    integ += (vec2_k1+vec2_k2)/2. * dp;
-    if(volume_avg)
-        return integ/V;
-    else
-        return integ;
-}
-
-//============================================================================//
-float integ_sumsquares_2D(float **vec, int *dims, bool volume_avg) {
-    float integ, dz, dr, dp, V;
-    get_diff_elems_and_volume(dims,dz,dr,dp,V);
-    integ = 2.*pi*integ_sumsquares_r(0,vec,dims,dr,dz);
-    if(volume_avg)
-        return integ/V;
-    else
-        return integ;
-}
-
-//============================================================================//
-float integ_sumsquares_r(int k, float **vec, int *dims, float dr, float dz) {
-    float integ, vec2_j1, vec2_j2;
-    integ = 0.0;    
-    for(int j=1; j<dims[1]; j++) {
-        vec2_j1 = integ_sumsquares_z(k,j-1,vec,dims,dz);
-        vec2_j2 = integ_sumsquares_z(k,j  ,vec,dims,dz);
-        integ += ((vec2_j1+vec2_j2)/2. * dr) * ((2.*j-1.)/2. * dr); // r*dr
-    }
-    return integ;
-}
-
-//============================================================================//
-float integ_sumsquares_z(int k, int j, float **vec, int *dims, float dz) {
-    int n1, n2;
-    float integ, vec2_i1, vec2_i2;
-    integ = 0.0;
-    for(int i=1; i<dims[0]; i++) {
-        n1 = fn(i-1,j,k,dims[0],dims[1]);
-        n2 = fn(i  ,j,k,dims[0],dims[1]);
-        vec2_i1 = 0.0;
-        vec2_i2 = 0.0;
-        for(int m=0; m<ndims; m++) {
-            vec2_i1 += vec[m][n1]*vec[m][n1];
-            vec2_i2 += vec[m][n2]*vec[m][n2];
-        }
-        integ += (vec2_i1+vec2_i2)/2. * dz;
-    }    
-    return integ;
-}
-
-//============================================================================//
-void get_diff_elems_and_volume(int *dims, float &dz, float &dr, float &dp, 
-                                float &V) {
-    dz = 2.*42.2222/(dims[0]-1);
-    dr = 28.1944/(dims[1]-1);
-    dp = 2*pi/dims[2];
-    V  = pi*(28.1944*28.1944)*(2.*42.2222);
-}
+void Fourier_Modes_Slab(int,int,void*);
 
 //============================================================================//
 //============================================================================//
@@ -124,5 +55,309 @@ void Fourier_Decomp(float **vec, int *dims, int i, int j, int vec_comp,
 
 //============================================================================//
 //============================================================================//
+struct ModeArgs {
+    float *vals;        // Vector component being decomposed
+    int Nq, Nr, Ns;     // Dimensions of the stripped variable
+    int layout;         // Layout of vals (layout_fn or layout_phi)
+    int Nmodes;         // Number of modes returned (n = 0 to Nmodes-1)
+    float **amp;        // Amplitude of each mode over the (z,r) plane
+    float **phase;      // Phase of each mode over the (z,r) plane (or NULL)
+    double *wr, *wi;    // Twiddle factors exp(-2*pi*i*k/Ns)
+    int *bitrev;        // Bit reversal of the half-length FFT (or NULL)
+};
 
+//============================================================================//
+void Fourier_Modes(float **vec, int *dims, int vec_comp, int Nmodes,
+                   float **amp, float **phase, int layout) {
+    // Batched azimuthal Fourier decomposition of one vector component over 
+    // every (z,r) column.  For each mode n < Nmodes (at most Ns/2+1), 
+    // amp[n] and phase[n] (if phase is not NULL) are filled over the (z,r) 
+    // plane at fn(i,j,0,Nq,Nr).  The amplitudes follow Fourier_Decomp:
+    // c0 = |X_0|/Ns and cn = sqrt(2)*|X_n|/Ns (the rms of the mode), except
+    // that the Nyquist mode n = Ns/2 is |X_n|/Ns.  The phase is arg(X_n) 
+    // with X_n = sum_k v_k exp(-2*pi*i*n*k/Ns), so v ~ cn*sqrt(2)*cos(n*phi
+    // + phase).  Columns are transformed with a real FFT (two points packed 
+    // per complex point) when Ns is a power of two and with a table-driven 
+    // DFT otherwise; the z range is split over the threads.  With layout_phi,
+    // vec is in the fn_phi layout and its phi columns are read in place.
+    int Ns = dims[2];
+    StageTimer timer(stage_analysis,(long)dims[0]*dims[1]*Ns*sizeof(float));
+    ModeArgs args;
+    args.vals = vec[vec_comp];
+    args.Nq = dims[0];
+    args.Nr = dims[1];
+    args.Ns = Ns;
+    args.layout = layout;
+    args.Nmodes = (Nmodes < Ns/2+1) ? Nmodes : Ns/2+1;
+    args.amp = amp;
+    args.phase = phase;
+    
+    // Twiddle factors for the full length (the half-length FFT uses every 
+    // second entry):
+    args.wr = new double[Ns];
+    args.wi = new double[Ns];
+    for(int k=0; k<Ns; k++) {
+        args.wr[k] =  cos(2.*pi*k/(1.*Ns));
+        args.wi[k] = -sin(2.*pi*k/(1.*Ns));
+    }
+    
+    // Bit reversal of the half-length complex FFT (power-of-two Ns only):
+    args.bitrev = NULL;
+    int M = Ns/2;
+    if(Ns >= 4 && (Ns & (Ns-1)) == 0) {
+        int Nbits = 0;
+        while((1 << Nbits) < M)
+            Nbits++;
+        args.bitrev = new int[M];
+        for(int k=0; k<M; k++) {
+            int r = 0;
+            for(int b=0; b<Nbits; b++)
+                r |= ((k >> b) & 1) << (Nbits-1-b);
+            args.bitrev[k] = r;
+        }
+    }
+    
+    Parallel_For(args.Nq,Fourier_Modes_Slab,&args);
+    
+    delete [] args.wr;
+    delete [] args.wi;
+    if(args.bitrev != NULL)
+        delete [] args.bitrev;
+}
 
+//============================================================================//
+void Fourier_Modes_Slab(int i1, int i2, void *arg) {
+    // Transforms the columns of the z slab [i1,i2) (see Fourier_Modes)
+    ModeArgs *a = (ModeArgs*)arg;
+    int Nq = a->Nq, Nr = a->Nr, Ns = a->Ns, M = Ns/2, stride = Nq*Nr;
+    double *col = new double[Ns];
+    float *src;
+    double *Xr = new double[Ns/2+1], *Xi = new double[Ns/2+1];
+    double *zr = new double[M], *zi = new double[M];
+    double norm, mag;
+    
+    for(int i=i1; i<i2; i++) {
+        for(int j=0; j<Nr; j++) {
+            int n0 = fn(i,j,0,Nq,Nr);
+            if(a->layout == layout_phi) {
+                src = a->vals + fn_phi(i,j,0,Nq,Ns);
+                for(int k=0; k<Ns; k++)
+                    col[k] = src[k];
+            }
+            else {
+                for(int k=0; k<Ns; k++)
+                    col[k] = a->vals[n0+k*stride];
+            }
+            
+            if(a->bitrev != NULL) {
+                // Pack the even and odd points into a half-length sequence:
+                for(int k=0; k<M; k++) {
+                    zr[a->bitrev[k]] = col[2*k];
+                    zi[a->bitrev[k]] = col[2*k+1];
+                }
+                // In-place radix-2 FFT (twiddles exp(-2*pi*i*k/M)):
+                for(int len=2; len<=M; len*=2) {
+                    int step = Ns/len;
+                    for(int s=0; s<M; s+=len) {
+                        for(int k=0; k<len/2; k++) {
+                            double wr = a->wr[k*step], wi = a->wi[k*step];
+                            int p = s+k, q = s+k+len/2;
+                            double tr = wr*zr[q] - wi*zi[q];
+                            double ti = wr*zi[q] + wi*zr[q];
+                            zr[q] = zr[p] - tr;  zi[q] = zi[p] - ti;
+                            zr[p] = zr[p] + tr;  zi[p] = zi[p] + ti;
+                        }
+                    }
+                }
+                // Separate the spectra of the even and odd points:
+                for(int n=0; n<a->Nmodes; n++) {
+                    int p = n % M, q = (M-n) % M;
+                    double er = 0.5*(zr[p] + zr[q]), ei = 0.5*(zi[p] - zi[q]);
+                    double orr = 0.5*(zi[p] + zi[q]), oi = -0.5*(zr[p] - zr[q]);
+                    double wr = a->wr[n % Ns], wi = a->wi[n % Ns];
+                    Xr[n] = er + wr*orr - wi*oi;
+                    Xi[n] = ei + wr*oi + wi*orr;
+                }
+            }
+            else {
+                // Direct DFT of the requested modes from the twiddle table:
+                for(int n=0; n<a->Nmodes; n++) {
+                    Xr[n] = 0.0;
+                    Xi[n] = 0.0;
+                    for(int k=0, nk=0; k<Ns; k++, nk=(nk+n)%Ns) {
+                        Xr[n] += col[k]*a->wr[nk];
+                        Xi[n] += col[k]*a->wi[nk];
+                    }
+                }
+            }
+            
+            for(int n=0; n<a->Nmodes; n++) {
+                norm = (n == 0 || 2*n == Ns) ? 1.0/Ns : sqrt(2.)/Ns;
+                mag = sqrt(Xr[n]*Xr[n] + Xi[n]*Xi[n]);
+                a->amp[n][n0] = norm*mag;
+                if(a->phase != NULL)
+                    a->phase[n][n0] = atan2(Xi[n],Xr[n]);
+            }
+        }
+    }
+    delete [] col;
+    delete [] Xr;
+    delete [] Xi;
+    delete [] zr;
+    delete [] zi;
+}
+
+//============================================================================//
+//############################################################################//
+//============================================================================//
+struct IntegArgs {
+    VolumeInteg *integ;  // Quadrature (weights and region)
+    float **vals;        // Field components
+    int ncomp;           // Number of components (0 for a plain scalar)
+    double *planes;      // Weighted sum over each phi plane of the region
+};
+
+//============================================================================//
+VolumeInteg::VolumeInteg(float **coords, int *dims) {
+    // Builds the trapezoidal quadrature over the node coordinates (z, r and 
+    // phi) of a stripped mesh (see SILO_Reader::GetMeshCoords).  The phi 
+    // direction is periodic when the full range is integrated.
+    for(int m=0; m<ndims; m++) {
+        this->dims[m] = dims[m];
+        this->coords[m] = new double[dims[m]];
+        for(int n=0; n<dims[m]; n++)
+            this->coords[m][n] = coords[m][n];
+        this->weights[m] = new double[dims[m]];
+    }
+    this->period = (dims[2] > 1) ? dims[2]*(coords[2][1]-coords[2][0]) : 2.*pi;
+    int lo[ndims] = {0,0,0};
+    this->SetRegion(lo,dims);
+}
+
+//============================================================================//
+VolumeInteg::~VolumeInteg(void) {
+    for(int m=0; m<ndims; m++) {
+        delete [] this->coords[m];
+        delete [] this->weights[m];
+    }
+}
+
+//============================================================================//
+void VolumeInteg::SetRegion(int *lo, int *hi) {
+    // Restricts the integrals to the node range [lo,hi) and recomputes the 
+    // weights.  Each interval between two nodes of the region contributes 
+    // half of its width (times the midpoint radius in r) to both nodes, so 
+    // the volume of the region is exact.
+    for(int m=0; m<ndims; m++) {
+        this->lo[m] = max(0,min(lo[m],this->dims[m]));
+        this->hi[m] = max(this->lo[m],min(hi[m],this->dims[m]));
+        double *x = this->coords[m], *w = this->weights[m];
+        for(int n=0; n<this->dims[m]; n++)
+            w[n] = 0.0;
+        for(int n=this->lo[m]; n<this->hi[m]-1; n++) {
+            double dx = 0.5*(x[n+1]-x[n]);
+            if(m == 1)
+                dx *= 0.5*(x[n]+x[n+1]);
+            w[n] += dx;
+            w[n+1] += dx;
+        }
+    }
+    // Close the phi interval across the periodic seam:
+    int Ns = this->dims[2];
+    if(this->lo[2] == 0 && this->hi[2] == Ns && Ns > 0) {
+        double dx = 0.5*(this->period - (this->coords[2][Ns-1] - 
+                                         this->coords[2][0]));
+        this->weights[2][Ns-1] += dx;
+        this->weights[2][0] += dx;
+    }
+}
+
+//============================================================================//
+double VolumeInteg::Volume(void) {
+    // Volume of the region
+    double V[ndims];
+    for(int m=0; m<ndims; m++) {
+        V[m] = 0.0;
+        for(int n=this->lo[m]; n<this->hi[m]; n++)
+            V[m] += this->weights[m][n];
+    }
+    return V[0]*V[1]*V[2];
+}
+
+//============================================================================//
+double VolumeInteg::Integrate(float *var) {
+    // Integral of a scalar field over the region
+    return this->Sum(&var,0);
+}
+
+//============================================================================//
+double VolumeInteg::IntegrateSquares(float **vec, int ncomp) {
+    // Integral of the squared norm of a field of ncomp components over the 
+    // region (e.g. ncomp = 3 for 2x the magnetic energy of a vector field)
+    return this->Sum(vec,ncomp);
+}
+
+//============================================================================//
+double VolumeInteg::RadialAverage(float *var_r) {
+    // Area-weighted (r dr) average of a radial profile over the r range of 
+    // the region
+    double sum = 0.0, area = 0.0;
+    for(int j=this->lo[1]; j<this->hi[1]; j++) {
+        sum += this->weights[1][j]*var_r[j];
+        area += this->weights[1][j];
+    }
+    return (area > 0.0) ? sum/area : 0.0;
+}
+
+//============================================================================//
+double VolumeInteg::Sum(float **vals, int ncomp) {
+    // Weighted sum of the field over the region.  The phi planes are split 
+    // over the threads and their sums are added in order afterwards, so the
+    // result does not depend on the number of threads.
+    int Nk = this->hi[2] - this->lo[2];
+    StageTimer timer(stage_analysis,(long)((ncomp > 0) ? ncomp : 1)*Nk*
+                     (this->hi[0]-this->lo[0])*(this->hi[1]-this->lo[1])*
+                     sizeof(float));
+    double *planes = new double[Nk], total = 0.0;
+    IntegArgs args = {this,vals,ncomp,planes};
+    Parallel_For(Nk,Sum_Slab,&args);
+    for(int k=0; k<Nk; k++)
+        total += this->weights[2][this->lo[2]+k]*planes[k];
+    delete [] planes;
+    return total;
+}
+
+//============================================================================//
+void VolumeInteg::Sum_Slab(int k1, int k2, void *arg) {
+    // Weighted (z,r) sums of the phi planes [k1,k2) of the region
+    IntegArgs *a = (IntegArgs*)arg;
+    VolumeInteg *v = a->integ;
+    int Nq = v->dims[0], Nr = v->dims[1];
+    int i1 = v->lo[0], i2 = v->hi[0];
+    double *wq = v->weights[0], *wr = v->weights[1];
+    for(int kk=k1; kk<k2; kk++) {
+        int k = v->lo[2] + kk;
+        double plane = 0.0;
+        for(int j=v->lo[1]; j<v->hi[1]; j++) {
+            long n0 = fn(0,j,k,Nq,Nr);
+            double row = 0.0;
+            if(a->ncomp == 0) {
+                float *f = a->vals[0] + n0;
+                for(int i=i1; i<i2; i++)
+                    row += wq[i]*f[i];
+            }
+            else {
+                for(int c=0; c<a->ncomp; c++) {
+                    float *f = a->vals[c] + n0;
+                    for(int i=i1; i<i2; i++)
+                        row += wq[i]*((double)f[i]*f[i]);
+                }
+            }
+            plane += wr[j]*row;
+        }
+        a->planes[kk] = plane;
+    }
+}
+
+//============================================================================//
+//============================================================================//
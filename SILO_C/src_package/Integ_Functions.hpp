@@ -4,6 +4,7 @@
 Clayton Myers
 Interp_Functions.hpp
 Created:  28 July 2010
+Modified: 17 October 2026
 
 Header file for interpolation functions.
 
@@ -11,10 +12,38 @@ Header file for interpolation functions.
 //============================================================================//
 //============================================================================//
 
-float integ_sumsquares_3D(float**,int*,bool);
-float integ_sumsquares_2D(float**,int*,bool);
+//============================================================================//
+// Trapezoidal quadrature over the (z,r,phi) node coordinates of a stripped 
+// mesh.  The weights are computed once per mesh (or region) and the integrals
+// are accumulated in double precision over threads split in phi.
+class VolumeInteg {
+    public:
+        VolumeInteg(float**,int*);
+        ~VolumeInteg(void);
+        void SetRegion(int*,int*);
+        double Volume(void);
+        double Integrate(float*);
+        double IntegrateSquares(float**,int);
+        double RadialAverage(float*);
+        
+    protected:
+        int dims[ndims];          // Dimensions of the stripped mesh
+        int lo[ndims], hi[ndims]; // Node range [lo,hi) of the region
+        double *coords[ndims];    // Node coordinates (z, r and phi)
+        double *weights[ndims];   // Trapezoidal weights over the region
+        double period;            // Period of phi
+        
+        double Sum(float**,int);
+        static void Sum_Slab(int,int,void*);
+        
+    private:
+        VolumeInteg(const VolumeInteg&);
+        VolumeInteg &operator=(const VolumeInteg&);
+};
 
+//============================================================================//
 void Fourier_Decomp(float**,int*,int,int,int,float&,float&);
+void Fourier_Modes(float**,int*,int,int,float**,float**,int);
 
 //============================================================================//
 //============================================================================//
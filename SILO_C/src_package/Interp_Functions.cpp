@@ -4,6 +4,7 @@
 Clayton Myers
 Interp_Functions.cpp
 Created:  28 July 2010
+Modified: 17 October 2026
 
 Interpolation support for 1D and 2D arrays
 
@@ -12,6 +13,8 @@ Interpolation support for 1D and 2D arrays
 //============================================================================//
 
 #include <HYM_SILO.hpp>
+#include <Interp_Functions.hpp>
+#include <Stage_Timers.hpp>
 void find_nearest(float*,int,float,int&,int&);
 
 //============================================================================//
@@ -77,5 +80,147 @@ void find_nearest(float *xg, int Nx, float x, int &iL, int &iR) {
 }
 
 //============================================================================//
+//############################################################################//
 //============================================================================//
+ProbeArray::ProbeArray(int Np, float *z, float *r, float *phi, float **coords,
+                       int *dims, char *stopmsg) {
+    // Builds the trilinear stencils of the probes at (z[p],r[p],phi[p]) on the
+    // node coordinates (z, r and phi) of a stripped mesh (see
+    // SILO_Reader::GetMeshCoords).  phi is periodic with the period of the
+    // uniform phi planes (as in VolumeInteg); z and r must lie on the mesh.
+    // Nodes of zero weight are dropped, so a probe on a node reads one value.
+    int i[2], j[2], k[2];
+    float tz, tr, ts;
+    char name[101];
+    this->Np = Np;
+    for(int m=0; m<ndims; m++)
+        this->dims[m] = dims[m];
+    int Nq = dims[0], Nr = dims[1], Ns = dims[2];
+    this->offset = new int[Np+1];
+    this->node = new int[8*Np];
+    this->weight = new float[8*Np];
+    this->planes = new bool[Ns];
+    for(int n=0; n<Ns; n++)
+        this->planes[n] = false;
 
+    // phi planes closed across the periodic seam above the last plane:
+    float *s = new float[Ns+1];
+    float period = (Ns > 1) ? Ns*(coords[2][1]-coords[2][0]) : 2.*pi;
+    for(int n=0; n<Ns; n++)
+        s[n] = coords[2][n];
+    s[Ns] = coords[2][0] + period;
+
+    int nnz = 0;
+    for(int p=0; p<Np; p++) {
+        this->offset[p] = nnz;
+        sprintf(name,"z of probe %d",p+1);
+        this->Bracket(coords[0],Nq,z[p],i[0],i[1],tz,name,stopmsg);
+        sprintf(name,"r of probe %d",p+1);
+        this->Bracket(coords[1],Nr,r[p],j[0],j[1],tr,name,stopmsg);
+        float sp = fmod(phi[p]-s[0],period);
+        if(sp < 0.)
+            sp += period;
+        sprintf(name,"phi of probe %d",p+1);
+        this->Bracket(s,Ns+1,s[0]+sp,k[0],k[1],ts,name,stopmsg);
+        if(k[0] == Ns)
+            k[0] = 0;
+        if(k[1] == Ns)
+            k[1] = 0;
+
+        // Corners of the stencil (z fastest):
+        float wz[2] = {1.f-tz,tz}, wr[2] = {1.f-tr,tr}, ws[2] = {1.f-ts,ts};
+        for(int c=0; c<8; c++) {
+            int a = c%2, b = (c/2)%2, d = c/4;
+            float w = wz[a]*wr[b]*ws[d];
+            if(w == 0.f)
+                continue;
+            this->node[nnz] = fn(i[a],j[b],k[d],Nq,Nr);
+            this->weight[nnz] = w;
+            this->planes[k[d]] = true;
+            nnz++;
+        }
+    }
+    this->offset[Np] = nnz;
+    delete [] s;
+}
+
+//============================================================================//
+ProbeArray::~ProbeArray(void) {
+    delete [] this->offset;
+    delete [] this->node;
+    delete [] this->weight;
+    delete [] this->planes;
+}
+
+//============================================================================//
+int ProbeArray::Nprobes(void) {
+    return this->Np;
+}
+
+//============================================================================//
+bool *ProbeArray::Planes(void) {
+    // Flags of the phi planes read by the stencils (see
+    // SILO_Reader::ReadVectorPlanes)
+    return this->planes;
+}
+
+//============================================================================//
+void ProbeArray::Sample(float *var, float *vals) {
+    // Samples a stripped mesh variable at every probe into vals[Np]
+    StageTimer timer(stage_analysis,(long)this->offset[this->Np]*sizeof(float));
+    for(int p=0; p<this->Np; p++) {
+        double sum = 0.;
+        for(int n=this->offset[p]; n<this->offset[p+1]; n++)
+            sum += this->weight[n]*var[this->node[n]];
+        vals[p] = (float)sum;
+    }
+}
+
+//============================================================================//
+int *ProbeArray::Nodes(int &Nnodes) {
+    // Linear mesh indices of the stencil nodes of all probes in turn, for 
+    // gathering them without the full variable (see Apply)
+    Nnodes = this->offset[this->Np];
+    return this->node;
+}
+
+//============================================================================//
+void ProbeArray::Apply(float *node_vals, float *vals) {
+    // Samples every probe into vals[Np] from the values at the stencil nodes
+    // (node_vals[n] is the value at Nodes()[n])
+    StageTimer timer(stage_analysis,(long)this->offset[this->Np]*sizeof(float));
+    for(int p=0; p<this->Np; p++) {
+        double sum = 0.;
+        for(int n=this->offset[p]; n<this->offset[p+1]; n++)
+            sum += this->weight[n]*node_vals[n];
+        vals[p] = (float)sum;
+    }
+}
+
+//============================================================================//
+void ProbeArray::Bracket(float *xg, int Nx, float x, int &iL, int &iR,
+                         float &t, char *name, char *stopmsg) {
+    // Finds the nodes iL and iR about x in the increasing coordinates xg and
+    // the fractional distance t of x from iL
+    float tol = 1.e-5*((Nx > 1) ? xg[Nx-1]-xg[0] : 1.);
+    if(x < xg[0]-tol || x > xg[Nx-1]+tol) {
+        char message[1001];
+        sprintf(message,"  The %s (%g) %s [%g,%g].\n  %s",name,x,
+                "lies outside of the mesh range",xg[0],xg[Nx-1],stopmsg);
+        StopExecution(message);
+    }
+    if(Nx == 1) {
+        iL = iR = 0;
+        t = 0.;
+        return;
+    }
+    find_nearest(xg,Nx,x,iL,iR);
+    t = (x-xg[iL])/(xg[iR]-xg[iL]);
+    if(t < 0.)
+        t = 0.;
+    else if(t > 1.)
+        t = 1.;
+}
+
+//============================================================================//
+//============================================================================//
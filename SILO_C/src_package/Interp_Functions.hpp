@@ -4,6 +4,7 @@
 Clayton Myers
 Interp_Functions.hpp
 Created:  28 July 2010
+Modified: 17 October 2026
 
 Header file for interpolation functions.
 
@@ -11,6 +12,37 @@ Header file for interpolation functions.
 //============================================================================//
 //============================================================================//
 
+//============================================================================//
+// Trilinear sampling of mesh variables at fixed probe positions.  The stencil
+// (nodes and weights in z, r and periodic phi) of each probe is found once
+// against the node coordinates of a stripped mesh and every sample is then a 
+// short weighted gather.
+class ProbeArray {
+    public:
+        ProbeArray(int,float*,float*,float*,float**,int*,char*);
+        ~ProbeArray(void);
+        int Nprobes(void);
+        bool *Planes(void);
+        void Sample(float*,float*);
+        int *Nodes(int&);
+        void Apply(float*,float*);
+        
+    protected:
+        int Np;                  // Number of probes
+        int dims[ndims];         // Dimensions of the stripped mesh
+        int *offset;             // Start of the stencil of each probe (Np+1)
+        int *node;               // Linear mesh index of each stencil node
+        float *weight;           // Trilinear weight of each stencil node
+        bool *planes;            // phi planes used by any stencil
+        
+        void Bracket(float*,int,float,int&,int&,float&,char*,char*);
+        
+    private:
+        ProbeArray(const ProbeArray&);
+        ProbeArray &operator=(const ProbeArray&);
+};
+
+//============================================================================//
 float interp_1d(float*,int,float*,float);
 float interp_1d_pts(float,float,float,float,float);
 float interp_2d(float*,int,float*,int,float*,float,float);
@@ -0,0 +1,102 @@
+//============================================================================//
+/*
+
+Clayton Myers
+Layout_Functions.cpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Conversions between the standard fn(i,j,k) field layout, in which each phi 
+column (fixed i and j) is strided by Nq*Nr values, and the phi-innermost
+fn_phi(i,j,k) layout, in which each phi column is contiguous.  The azimuthal
+analysis functions accept either layout; the conversions are explicit (never
+implicit in the analysis functions) and are cache-blocked and split over the
+threads.
+
+*/
+//============================================================================//
+//============================================================================//
+
+#include <HYM_SILO.hpp>
+#include <Layout_Functions.hpp>
+#include <Thread_Functions.hpp>
+
+void Transpose_Slab(int,int,void*);
+
+const int tile = 32;  // Edge of the square tiles of Transpose_Blocked
+
+struct TransposeArgs {
+    float *src;         // Source matrix (rows x cols, row major)
+    float *dst;         // Transposed matrix (cols x rows, row major)
+    int rows, cols;     // Dimensions of the source matrix
+    bool split_cols;    // Tiles are split over threads by column (else row)
+};
+
+//============================================================================//
+//============================================================================//
+int fn_phi(int i, int j, int k, int Nz, int Ns) {
+    // Transforms the 3D indices (i,j,k) to the linear index n of the 
+    // phi-innermost layout
+    return (j*Nz + i)*Ns + k;
+}
+
+//============================================================================//
+void To_Phi_Layout(float *var, float *&var_phi, int *dims) {
+    // Copies a stripped fn(i,j,k) variable into the fn_phi(i,j,k) layout 
+    // (var_phi is allocated if NULL).  The fn layout is an Ns x (Nq*Nr) 
+    // matrix whose transpose is the fn_phi layout.
+    int Nplane = dims[0]*dims[1];
+    if(var_phi == NULL)
+        var_phi = new float[Nplane*dims[2]];
+    Transpose_Blocked(var,var_phi,dims[2],Nplane);
+}
+
+//============================================================================//
+void From_Phi_Layout(float *var_phi, float *&var, int *dims) {
+    // Copies a fn_phi(i,j,k) variable back into the fn(i,j,k) layout (var is
+    // allocated if NULL)
+    int Nplane = dims[0]*dims[1];
+    if(var == NULL)
+        var = new float[Nplane*dims[2]];
+    Transpose_Blocked(var_phi,var,Nplane,dims[2]);
+}
+
+//============================================================================//
+void Transpose_Blocked(float *src, float *dst, int rows, int cols) {
+    // Transposes the rows x cols matrix src into dst in square tiles so that
+    // both the reads and the writes stay within a few cache lines per tile.
+    // The tiles along the longer dimension are split over the threads.
+    TransposeArgs args = {src,dst,rows,cols,cols >= rows};
+    int Ntiles = ((args.split_cols ? cols : rows) + tile-1)/tile;
+    Parallel_For(Ntiles,Transpose_Slab,&args);
+}
+
+//============================================================================//
+void Transpose_Slab(int t1, int t2, void *arg) {
+    // Transposes the tiles [t1,t2) along the split dimension (see 
+    // Transpose_Blocked)
+    TransposeArgs *a = (TransposeArgs*)arg;
+    int r1, r2, c1, c2;
+    if(a->split_cols) {
+        r1 = 0;          r2 = a->rows;
+        c1 = t1*tile;    c2 = min(t2*tile,a->cols);
+    }
+    else {
+        r1 = t1*tile;    r2 = min(t2*tile,a->rows);
+        c1 = 0;          c2 = a->cols;
+    }
+    for(int rb=r1; rb<r2; rb+=tile) {
+        int re = min(rb+tile,r2);
+        for(int cb=c1; cb<c2; cb+=tile) {
+            int ce = min(cb+tile,c2);
+            for(int c=cb; c<ce; c++) {
+                float *out = a->dst + (long)c*a->rows;
+                for(int r=rb; r<re; r++)
+                    out[r] = a->src[(long)r*a->cols + c];
+            }
+        }
+    }
+}
+
+//============================================================================//
+//============================================================================//
@@ -0,0 +1,25 @@
+//============================================================================//
+/*
+
+Clayton Myers
+Layout_Functions.hpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Header file for the field layout conversion functions.
+
+*/
+//============================================================================//
+//============================================================================//
+
+// Storage order of a field (see Layout_Functions.cpp):
+const int layout_fn  = 0;  // fn(i,j,k): z fastest, phi slowest (default)
+const int layout_phi = 1;  // fn_phi(i,j,k): phi fastest, then z, then r
+
+int fn_phi(int,int,int,int,int);
+void To_Phi_Layout(float*,float*&,int*);
+void From_Phi_Layout(float*,float*&,int*);
+void Transpose_Blocked(float*,float*,int,int);
+
+//============================================================================//
+//============================================================================//
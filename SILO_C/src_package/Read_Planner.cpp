@@ -0,0 +1,149 @@
+//============================================================================//
+/*
+
+Clayton Myers
+Read_Planner.cpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Coalescing planner for the positional reads of the raw HYM binary files.  The
+readers (the cycle headers, the time vector, the records and the point
+gathers of HYMDataObj) describe what they need as a batch of (offset, length)
+requests, and the planner turns the batch into a few large sorted reads so
+that a network filesystem sees a handful of requests instead of thousands of
+small ones.
+
+*/
+//============================================================================//
+//============================================================================//
+
+#include <HYM_SILO.hpp>
+#include <Read_Planner.hpp>
+
+#include <algorithm>   // For sort in Execute
+#include <cerrno>      // For errno in ReadAt
+
+// Read sizes of the merged reads (a few filesystem blocks cost about as much
+// as one seek; the buffer of a merged read is bounded by max_read):
+long ReadPlan::merge_gap = 65536;
+long ReadPlan::max_read = 16L*1024*1024;
+long ReadPlan::align = 4096;
+
+//============================================================================//
+//============================================================================//
+ReadPlan::ReadPlan(void) {
+    this->reads = 0;
+}
+
+//============================================================================//
+void ReadPlan::Add(long offset, long length, char *dest) {
+    // Adds a request for length bytes at offset, to be copied to dest
+    if(length <= 0)
+        return;
+    Request request = {offset,length,dest};
+    this->requests.push_back(request);
+}
+
+//============================================================================//
+void ReadPlan::Execute(int fd, char *map_base, long map_length) {
+    // Executes the requests from the file descriptor fd, or copies them from
+    // the mapping map_base of the file where it covers them.  The requests are
+    // cleared afterwards.
+    vector<Request> &req = this->requests;
+    vector<char> buffer;
+    int N = (int)req.size();
+    this->reads = 0;
+    sort(req.begin(),req.end());
+
+    int a = 0;
+    while(a < N) {
+        // Extend the run while the next request is near and the read small:
+        long start = req[a].offset - req[a].offset%ReadPlan::align;
+        long end = req[a].offset + req[a].length;
+        int b = a+1;
+        while(b < N && req[b].offset - end <= ReadPlan::merge_gap) {
+            long next_end = max(end,req[b].offset + req[b].length);
+            if(next_end - start > ReadPlan::max_read)
+                break;
+            end = next_end;
+            b++;
+        }
+
+        if(map_base != NULL && end <= map_length) {
+            for(int m=a; m<b; m++)
+                memcpy(req[m].dest,map_base+req[m].offset,req[m].length);
+        }
+        else if(b == a+1) {
+            ReadPlan::ReadAt(fd,req[a].offset,req[a].dest,req[a].length);
+            this->reads++;
+        }
+        else {
+            long nbytes = end - start;
+            if(nbytes%ReadPlan::align != 0)
+                nbytes += ReadPlan::align - nbytes%ReadPlan::align;
+            buffer.resize(nbytes);
+            ReadPlan::ReadAt(fd,start,&buffer[0],nbytes);
+            this->reads++;
+            for(int m=a; m<b; m++)
+                memcpy(req[m].dest,&buffer[req[m].offset-start],req[m].length);
+        }
+        a = b;
+    }
+    this->Clear();
+}
+
+//============================================================================//
+void ReadPlan::Clear(void) {
+    this->requests.clear();
+}
+
+//============================================================================//
+int ReadPlan::Nrequests(void) {
+    return (int)this->requests.size();
+}
+
+//============================================================================//
+long ReadPlan::Nbytes(void) {
+    // Number of bytes requested since the last Execute
+    long nbytes = 0;
+    for(int m=0; m<(int)this->requests.size(); m++)
+        nbytes += this->requests[m].length;
+    return nbytes;
+}
+
+//============================================================================//
+int ReadPlan::Nreads(void) {
+    // Number of reads issued by the last Execute (copies from a mapping are
+    // not counted)
+    return this->reads;
+}
+
+//============================================================================//
+void ReadPlan::ReadAt(int fd, long pos, char *buffer, long nbytes) {
+    // Reads nbytes from fd at the byte offset pos.  Bytes past the end of the
+    // file (the alignment padding of a merged read, or the missing tail of a
+    // record that is still being written) are zeroed; a failed read stops.
+    long nread = 0;
+    ssize_t n;
+    while(nread < nbytes) {
+        n = pread(fd,buffer+nread,(size_t)(nbytes-nread),(off_t)(pos+nread));
+        if(n < 0 && errno == EINTR)
+            continue;
+        if(n < 0) {
+            char message[1001];
+            sprintf(message,"      %s%ld%s%ld%s\n      %s%s\n      %s",
+                    "Unable to read ",nbytes-nread," bytes at offset ",
+                    pos+nread," of a binary file:","Error: ",strerror(errno),
+                    "Stopping on a read failure.");
+            StopExecution(message);
+        }
+        if(n == 0)
+            break;
+        nread += n;
+    }
+    if(nread < nbytes)
+        memset(buffer+nread,0,(size_t)(nbytes-nread));
+}
+
+//============================================================================//
+//============================================================================//
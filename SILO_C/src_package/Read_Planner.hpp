@@ -0,0 +1,53 @@
+//============================================================================//
+/*
+
+Clayton Myers
+Read_Planner.hpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Header file for the coalescing read planner of the raw binary readers.
+
+*/
+//============================================================================//
+//============================================================================//
+
+#include <vector>
+
+//============================================================================//
+// A batch of positional reads from one file.  The requests (offset, length
+// and destination) are collected with Add and executed together: they are
+// sorted by offset, requests separated by at most merge_gap bytes are merged
+// into one aligned read of at most max_read bytes, and the bytes are scattered
+// back to their destinations.  A request that is not merged is read straight
+// into its destination.  Bytes past the end of the file are zeroed.
+class ReadPlan {
+    public:
+        static long merge_gap;   // Largest gap bridged by a merged read
+        static long max_read;    // Largest merged read in bytes
+        static long align;       // Alignment of the merged reads in bytes
+
+        ReadPlan(void);
+        void Add(long,long,char*);
+        void Execute(int,char*,long);
+        void Clear(void);
+        int Nrequests(void);
+        long Nbytes(void);
+        int Nreads(void);
+        static void ReadAt(int,long,char*,long);
+
+    protected:
+        struct Request {
+            long offset;         // Offset of the request in the file
+            long length;         // Length of the request in bytes
+            char *dest;          // Destination of the bytes
+            bool operator<(const Request &other) const {
+                return this->offset < other.offset;
+            }
+        };
+        std::vector<Request> requests;  // Requests since the last Execute
+        int reads;               // Reads issued by the last Execute
+};
+
+//============================================================================//
+//============================================================================//
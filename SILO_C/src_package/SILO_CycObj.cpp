@@ -4,7 +4,7 @@
 Clayton Myers
 SILO_CycleObj.cpp
 Created:  06 February 2010
-Modified: 06 February 2010
+Modified: 17 October 2026
 
 Class for SILO cycle objects..
                       
@@ -16,12 +16,36 @@ Class for SILO cycle objects..
 #include <HYM_DataObj.hpp>
 #include <SILO_Write.hpp>
 #include <SILO_CycObj.hpp>
+#include <Buffer_Pool.hpp>
+#include <Stage_Timers.hpp>
+#include <Thread_Functions.hpp>
+
+#include <sys/stat.h>  // For stat in Open_Series and Add_Time_Index
 
 //============================================================================//
 //============================================================================//
 
 char *silo_name = "HYM";
 char *mesh_name = "HYM_mesh";
+char *mesh_file = "HYM_mesh.silo";  // Shared mesh file (--shared-mesh)
+char *data_dir  = "data";           // Directory of the variable blocks
+char *series_file = "HYM_series.silo"; // Time-series container (--series)
+char *time_index = "HYM_times.dat";    // Time of each cycle written
+
+bool SILO_CycObj::shared_mesh = false;
+float **SILO_CycObj::mesh_src = NULL;
+float *SILO_CycObj::mesh_cache[ndims] = {NULL,NULL,NULL};
+int SILO_CycObj::mesh_cache_dims[ndims] = {0,0,0};
+bool SILO_CycObj::mesh_file_written = false;
+bool SILO_CycObj::series = false;
+long SILO_CycObj::mem_budget = 0;
+int *SILO_CycObj::mesh_src_dims = NULL;
+DBfile *SILO_CycObj::series_dbfile = NULL;
+int SILO_CycObj::Nseries = 0;
+int SILO_CycObj::series_capacity = 0;
+int *SILO_CycObj::series_cycles = NULL;
+double *SILO_CycObj::series_times = NULL;
+std::set<std::string> SILO_CycObj::indexed_paths;
 
 //============================================================================//
 //============================================================================//
@@ -36,22 +60,30 @@ SILO_CycObj::SILO_CycObj(int cycle, float **mesh_coords, int *dims,
     this->time_str=NULL;
     this->stat_str="Clean";
     
+    for(int m=0; m<nvars; m++) {
+        for(int mm=0; mm<ndims; mm++)
+            this->vals[m][mm] = NULL;
+    }
+    
     this->SetFlags(glob_data_flags);
     this->SetTime(); 
-    if(halfcyl){
-    	this->silodims = {dims[0],dims[1],dims[2]+1};
-    }else{
-    	this->silodims = {dims[0],dims[1],dims[2]+2*Nghost+1};
-    }
+    this->dims = dims;
     
+    // List the variables to be converted as independent tasks:
+    this->Ntasks = 0;
+    for(int m=0; m<nvars; m++) {
+        if(this->mask_flags[m]) {
+            this->task_vars[this->Ntasks] = m;
+            this->Ntasks++;
+        }
+    }
 }
 
 //============================================================================//
 SILO_CycObj::~SILO_CycObj(void) { 
-    return;
+    this->Free_Data();
 }
 
-
 //============================================================================//
 void SILO_CycObj::SetFlags(bool *glob_data_flags) {
     this->write_flag  = false;
@@ -100,300 +132,474 @@ void SILO_CycObj::SetTime(void) {
 
 //============================================================================//
 void SILO_CycObj::Write_SILO(char *silo_path) {
-    // Write out the SILO database filename:
-    char full_name[1001];
-    sprintf(full_name,"%s%s_%0.3d.silo",silo_path,silo_name,this->cycle);
+    // Converts this cycle in one pass (see Read_Data, Transform_Data and 
+    // Put_SILO for the individual stages used by the conversion pipeline).
+    this->Read_Data();
+    this->Transform_Data();
+    this->Put_SILO(silo_path);
+}
+
+//============================================================================//
+void SILO_CycObj::Read_Data(void) {
+    // Reads the stripped binary data for each variable in this cycle (the 
+    // variables are read concurrently when threads are available).  In the
+    // low-memory mode (mem_budget) the data is read block by block when it
+    // is written instead (see Put_Blocks).
+    if(!write_flag || mem_budget > 0)
+        return;
+    StageTimer::Set_Cycle(this->cycle);
+    Parallel_Tasks(this->Ntasks,SILO_CycObj::Read_Task,this);
+    StageTimer::Set_Cycle(0);
+}
+
+//============================================================================//
+void SILO_CycObj::Read_Task(int task, void *arg) {
+    SILO_CycObj *cyc_obj = (SILO_CycObj*)arg;
+    int m = cyc_obj->task_vars[task];
+    StageTimer::Set_Cycle(cyc_obj->cycle);
+    cyc_obj->data_objs[m]->ReadData_Binary(cyc_obj->cycle,cyc_obj->vals[m]);
+}
+
+//============================================================================//
+void SILO_CycObj::Transform_Data(void) {
+    // Converts the stripped data to the SILO layout (ghost zones, Cartesian
+    // components and zero threshold)
+    if(!write_flag || mem_budget > 0)
+        return;
+    StageTimer::Set_Cycle(this->cycle);
+    Parallel_Tasks(this->Ntasks,SILO_CycObj::Transform_Task,this);
+    StageTimer::Set_Cycle(0);
+}
+
+//============================================================================//
+void SILO_CycObj::Transform_Task(int task, void *arg) {
+    SILO_CycObj *cyc_obj = (SILO_CycObj*)arg;
+    int m = cyc_obj->task_vars[task];
+    StageTimer::Set_Cycle(cyc_obj->cycle);
+    cyc_obj->data_objs[m]->TransformData_SILO(cyc_obj->vals[m],
+                                              cyc_obj->mesh_coords);
+}
+
+//============================================================================//
+void SILO_CycObj::Put_SILO(char *silo_path) {
+    // Write out the SILO database filename (or the directory name of this 
+    // cycle in the time-series container):
+    char full_name[1001], cycle_dir[1001];
+    sprintf(cycle_dir,"%s_%0.3d",silo_name,this->cycle);
+    if(series)
+        sprintf(full_name,"%s%s:/%s",silo_path,series_file,cycle_dir);
+    else
+        sprintf(full_name,"%s%s.silo",silo_path,cycle_dir);
 
     // Bail out if this SILO database should not be written:
     if(!write_flag) {
         cout << "      Ignored: " << full_name << "\n";
         return;
     }
+    // Keep a cycle that an earlier run already wrote to the container (its
+    // directory cannot be replaced in place):
+    if(series) {
+        Open_Series(silo_path,this->stopmsg);
+        if(Series_Has_Dir(cycle_dir)) {
+            cout << "      Kept:    " << full_name << " (already written)\n";
+            this->Free_Data();
+            return;
+        }
+    }
+    StageTimer::Set_Cycle(this->cycle);
     
-    // Open the .silo database file:
-    DBfile *dbfile = DBCreate(full_name,DB_CLOBBER,DB_LOCAL,"data",DB_PDB);   
-    // Write the mesh to the .silo database:
-    WriteMesh_SILO(dbfile,mesh_name,this->silodims,this->mesh_coords,
-                   this->cycle,this->time);    
-    // Write the data to the .silo database:
-    for(int m=0; m<nvars; m++) {
-        if(this->mask_flags[m]) {
-            this->data_objs[m]->WriteData_SILO(dbfile,this->cycle,mesh_name,
-                                               this->mesh_coords);
+    // Build the Cartesian mesh on the first write of the session:
+    Build_Mesh(this->mesh_coords,this->dims);
+    
+    // Open the .silo database file (or a new directory in the container):
+    DBfile *dbfile = NULL;
+    if(series) {
+        dbfile = Open_Series(silo_path,this->stopmsg);
+        DBMkDir(dbfile,cycle_dir);
+        DBSetDir(dbfile,cycle_dir);
+    }
+    else
+        dbfile = DBCreate(full_name,DB_CLOBBER,DB_LOCAL,"data",silo_driver);
+    if(Nblocks_q*Nblocks_s > 1 || mem_budget > 0) {
+        // Split the mesh and data into z/phi blocks:
+        if(shared_mesh)
+            Write_Mesh_File(silo_path);
+        this->Put_Blocks(dbfile);
+    }
+    else if(shared_mesh) {
+        // Refer to the shared mesh file and write the data into a directory
+        // of blocks with a multivar for each variable:
+        Write_Mesh_File(silo_path);
+        PutMeshRef_SILO(dbfile,mesh_name,mesh_file,this->cycle,this->time);
+        DBMkDir(dbfile,data_dir);
+        DBSetDir(dbfile,data_dir);
+        for(int m=0; m<nvars; m++) {
+            if(this->mask_flags[m])
+                this->data_objs[m]->PutData_SILO(dbfile,mesh_name,
+                                                 this->vals[m]);
+        }
+        DBSetDir(dbfile,"..");
+        for(int m=0; m<nvars; m++) {
+            if(this->mask_flags[m])
+                this->data_objs[m]->PutDataRef_SILO(dbfile,data_dir);
+        }
+    }
+    else {
+        // Write the mesh to the .silo database:
+        PutMesh_SILO(dbfile,mesh_name,mesh_cache,mesh_cache_dims,
+                     this->cycle,this->time);
+        PutTime_SILO(dbfile,this->cycle,this->time);
+        // Write the transformed data to the .silo database:
+        for(int m=0; m<nvars; m++) {
+            if(this->mask_flags[m])
+                this->data_objs[m]->PutData_SILO(dbfile,mesh_name,
+                                                 this->vals[m]);
         }
     }
+    // Mark vectors stored in their cylindrical components:
+    if(cyl_output)
+        PutCoordSys_SILO(dbfile);
     // Close the completed .silo database:
-    DBClose(dbfile);
-    cout << "      Output:  " << full_name << "\n";    
+    if(series) {
+        DBSetDir(dbfile,"/");
+        Add_Series_Entry(this->cycle,this->time);
+    }
+    else {
+        StageTimer timer(stage_close,0);
+        DBClose(dbfile);
+    }
+    Add_Time_Index(silo_path,this->cycle,this->time);
+    cout << "      Output:  " << full_name << "\n";
+    this->Free_Data();
+    StageTimer::Set_Cycle(0);
 }
 
 //============================================================================//
-void SILO_CycObj::Write_ASCII(char *ascii_path) {
-    VerifyPath(ascii_path,stopmsg);
+void SILO_CycObj::Free_Data(void) {
+    // Returns the arrays of this cycle to the session pool (see BufferPool)
     for(int m=0; m<nvars; m++) {
-        if(this-mask_flags[m]) {
-            this->data_objs[m]->WriteData_ASCII(ascii_path,this->cycle,
-                                                this->time,this->mesh_coords);
+        for(int mm=0; mm<ndims; mm++) {
+            BufferPool::Put(this->vals[m][mm]);
+            this->vals[m][mm] = NULL;
         }
-    }                 
+    }
 }
 
-//Code previously in Silo write
 //============================================================================//
+void SILO_CycObj::Build_Mesh(float **mesh_coords, int *dims) {
+    // Computes the Cartesian mesh once for the mesh coordinates of the session
+    // (in the low-memory mode only its dimensions; the blocks are computed 
+    // as they are written, see Put_Mesh_Block)
+    if(mesh_src == mesh_coords && (mesh_cache[0] != NULL || mem_budget > 0))
+        return;
+    Free_Mesh();
+    if(mem_budget > 0)
+        MeshDims_SILO(dims,mesh_cache_dims);
+    else
+        BuildMesh_SILO(dims,mesh_coords,mesh_cache,mesh_cache_dims);
+    mesh_src = mesh_coords;
+    mesh_src_dims = dims;
+}
 
-void WriteMesh_SILO(DBfile *dbfile, char *mesh_name, int *dims, 
-                    float **mesh_coords, int cycle, double time) {
-    int i, j, k, n, Ntot;
-    int Nq = dims[0], Nr = dims[1], Ns = dims[2];
-    float *q = mesh_coords[0], *r = mesh_coords[1], *s = mesh_coords[2];
-    float *s_ghost = NULL;
-    
+//============================================================================//
+void SILO_CycObj::Free_Mesh(void) {
+    for(int m=0; m<ndims; m++) {
+        if(mesh_cache[m] != NULL)
+            delete [] mesh_cache[m];
+        mesh_cache[m] = NULL;
+    }
+    mesh_src = NULL;
+    mesh_src_dims = NULL;
+    mesh_file_written = false;
+}
+
+//============================================================================//
+void SILO_CycObj::Write_Mesh_File(char *silo_path) {
+    // Writes the cached mesh to the shared mesh file (once per session)
+    if(mesh_file_written)
+        return;
+    char full_name[1001];
+    sprintf(full_name,"%s%s",silo_path,mesh_file);
+    DBfile *dbfile = DBCreate(full_name,DB_CLOBBER,DB_LOCAL,"mesh",
+                              silo_driver);
+    if(Nblocks_q*Nblocks_s > 1 || mem_budget > 0) {
+        char dir[1001];
+        for(int b=0; b<Nblocks_q*Nblocks_s; b++) {
+            sprintf(dir,"block_%d",b);
+            DBMkDir(dbfile,dir);
+            DBSetDir(dbfile,dir);
+            Put_Mesh_Block(dbfile,b,0,0.0);
+            DBSetDir(dbfile,"/");
+        }
+    }
+    else
+        PutMesh_SILO(dbfile,mesh_name,mesh_cache,mesh_cache_dims,0,0.0);
+    {
+        StageTimer timer(stage_close,0);
+        DBClose(dbfile);
+    }
+    cout << "      Output:  " << full_name << "\n";
+    mesh_file_written = true;
+}
 
-    //if halfcyl, just extend array. else ie. periodic, add ghost zones/
-    if(half_cyl){
-         Ns+=1;
-         s_ghost=new float[Ns];
-         //copy array across into new slightly alrger array
-         for(k=0;k<Ns-1;k++){
-                    s_ghost[k]=s[k];
-         }
-         //add final phi=pi point
-         s_ghost[Ns-1]=s_ghost[Ns-2]+s_ghost[1];
-    }else{
-         AddGhostZones_Coord(s,s_ghost,Ns);               
+//============================================================================//
+void SILO_CycObj::Put_Blocks(DBfile *dbfile) {
+    // Writes the mesh (unless it is in the shared mesh file) and the data as 
+    // z/phi blocks in the directories block_0 ... block_<Nblocks-1>, with a 
+    // multimesh and a multivar for each variable at the top level.  The 
+    // blocks are cut out with the threads; the SILO calls stay serialized.
+    // In the low-memory mode each block is read, transformed and written in
+    // turn, so that only one block of one variable is held at a time.  The
+    // mesh and variable blocks are cut from the same (ghosted) dimensions.
+    int Nblocks = Nblocks_q*Nblocks_s;
+    int lo[ndims], hi[ndims], gdims[ndims];
+    char dir[1001], *block_names[Nblocks];
+    MeshDims_SILO(this->dims,gdims);
+    for(int m=0; m<ndims; m++) {
+        if(gdims[m] != mesh_cache_dims[m]) {
+            char message[1001];
+            sprintf(message,"      %s%d%s%d%s%d%s\n      %s",
+                    "The variable blocks of dimension ",m," (",gdims[m],
+                    " nodes) do not match the mesh (",mesh_cache_dims[m],
+                    " nodes).",this->stopmsg);
+            StopExecution(message);
+        }
     }
-    Ntot = Nq*Nr*Ns;
     
-    float *xg=NULL, *yg=NULL, *zg=NULL;
-    xg = new float[Ntot];
-    yg = new float[Ntot];
-    zg = new float[Ntot];
-    
-    n = 0;
-    for(k=0; k<Ns; k++) { 
-        for(j=0; j<Nr; j++) {
-            for(i=0; i<Nq; i++) {
-                xg[n] = r[j]*cos(s_ghost[k]);
-                yg[n] = r[j]*sin(s_ghost[k]);
-                zg[n] = q[i];
-                n++;
-            } 
+    for(int b=0; b<Nblocks; b++) {
+        sprintf(dir,"block_%d",b);
+        DBMkDir(dbfile,dir);
+        DBSetDir(dbfile,dir);
+        if(!shared_mesh)
+            Put_Mesh_Block(dbfile,b,this->cycle,this->time);
+        BlockIndex_SILO(gdims,b,lo,hi);
+        for(int m=0; m<nvars; m++) {
+            if(!this->mask_flags[m])
+                continue;
+            if(mem_budget > 0)
+                this->data_objs[m]->StreamBlock_SILO(dbfile,mesh_name,
+                                                     this->cycle,
+                                                     this->mesh_coords,lo,hi);
+            else
+                this->data_objs[m]->PutDataBlock_SILO(dbfile,mesh_name,
+                                                      this->vals[m],lo,hi);
         }
+        DBSetDir(dbfile,"..");
     }
     
-    delete [] s_ghost;
-    
-    // Create the arrays to write to the .silo database:
-    int silodims[ndims] = {Nq,Nr,Ns};
-    float *coords[ndims] = {(float*)xg, (float*)yg, (float*)zg};
-    
-    // Create an option list to save cycle and time values:
-    DBoptlist *optlist = DBMakeOptlist(4);
-    if(!half_cyl){
-          int offset_low[ndims] = {0,0,Nghost};
-          int offset_high[ndims] = {0,0,Nghost};
-          DBAddOption(optlist, DBOPT_LO_OFFSET, offset_low);
-          DBAddOption(optlist, DBOPT_HI_OFFSET, offset_high);                  
+    for(int b=0; b<Nblocks; b++) {
+        block_names[b] = new char[1001];
+        if(shared_mesh)
+            sprintf(block_names[b],"%s:/block_%d/%s",mesh_file,b,mesh_name);
+        else
+            sprintf(block_names[b],"block_%d/%s",b,mesh_name);
     }
-    DBAddOption(optlist, DBOPT_DTIME, &time);
-    DBAddOption(optlist, DBOPT_CYCLE, &cycle);
-
-    // DBAddOption(optlist, DBOPT_COORDSYS, DB_CYLINDRICAL);
+    PutMultimesh_SILO(dbfile,mesh_name,Nblocks,block_names,this->cycle,
+                      this->time);
+    for(int b=0; b<Nblocks; b++)
+        delete [] block_names[b];
+    for(int m=0; m<nvars; m++) {
+        if(this->mask_flags[m])
+            this->data_objs[m]->PutBlockRefs_SILO(dbfile,Nblocks);
+    }
+    PutBlockIndex_SILO(dbfile,gdims);
+}
 
-    // Write the mesh to the .silo file:
-    DBPutQuadmesh(dbfile, mesh_name, NULL, coords, silodims, ndims,
-                  DB_FLOAT, DB_NONCOLLINEAR, optlist);
-                  
-    DBFreeOptlist(optlist);
-    
-    delete [] xg;
-    delete [] yg;
-    delete [] zg;
-    
+//============================================================================//
+void SILO_CycObj::Put_Mesh_Block(DBfile *dbfile, int b, int cycle, 
+                                 double time) {
+    // Writes block b of the cached mesh into the current directory of dbfile
+    // (the first and last phi blocks carry the phi ghost planes)
+    int lo[ndims], hi[ndims], bdims[ndims];
+    float *bcoords[ndims];
+    BlockIndex_SILO(mesh_cache_dims,b,lo,hi);
+    if(mem_budget > 0)
+        BuildMeshRange_SILO(mesh_src_dims,mesh_src,lo,hi,bcoords,bdims);
+    else
+        BuildMeshBlock_SILO(mesh_cache,mesh_cache_dims,lo,hi,bcoords,bdims);
+    PutMeshBlock_SILO(dbfile,mesh_name,bcoords,bdims,cycle,time,lo[2] == 0,
+                      hi[2] == mesh_cache_dims[2]);
+    for(int m=0; m<ndims; m++)
+        BufferPool::Put(bcoords[m]);
 }
 
 //============================================================================//
-void WriteScalar_SILO(DBfile *dbfile, char *vname, char *mesh_name, float *var, 
-                      int *dims) {
-    // This function writes the data in var to the .silo database file
-    int silodims[ndims] = {dims[0],dims[1],dims[2]+2*Nghost+1};
-    float *silovar;
-    if(halfcyl){
-          AddFinalZone_Var(var,silovar,dims);              
-    }else{
-          // Add the SILO ghost zones to the data:
-          AddGhostZones_Var(var,silovar,dims);
+DBfile *SILO_CycObj::Open_Series(char *silo_path, char *stopmsg) {
+    // Opens the time-series container on the first write of the session.  An
+    // existing container is extended (its cycle directories are kept and its
+    // time table is reloaded); otherwise a new one is created.
+    if(series_dbfile == NULL) {
+        char full_name[1001];
+        struct stat fstats;
+        sprintf(full_name,"%s%s",silo_path,series_file);
+        bool exists = (stat(full_name,&fstats) == 0);
+        if(exists)
+            series_dbfile = DBOpen(full_name,DB_UNKNOWN,DB_APPEND);
+        else
+            series_dbfile = DBCreate(full_name,DB_CLOBBER,DB_LOCAL,"series",
+                                     silo_driver);
+        if(series_dbfile == NULL) {
+            char message[1001];
+            sprintf(message,"      %s%s%s\n      %s","The SILO container \"",
+                    full_name,(exists) ? "\" could not be opened." : 
+                    "\" could not be created.",stopmsg);
+            StopExecution(message);
+        }
+        if(exists)
+            Load_Series_Table();
     }
-    // Remove nonzero elements below a threshold (e.g. 1e-10):
-    Set_Zeros(silovar,silodims[0]*silodims[1]*silodims[2]);
-    // Write the data to the .silo file:
-    DBPutQuadvar1(dbfile, vname, mesh_name, silovar, silodims, ndims, NULL, 0,
-                  DB_FLOAT, DB_NODECENT, NULL);
-    delete [] silovar;
+    return series_dbfile;
 }
 
 //============================================================================//
-void WriteVector_SILO(DBfile *dbfile, char *vname, char *mesh_name, 
-                      char **varnames, float **vec, float *s, int* dims) {
-    // This function writes the data in vec to the .silo database file
-    int Ntot;
-    int silodims[ndims] = {dims[0],dims[1],dims[2]+2*Nghost+1};
-    float *silovec[ndims];
-    if(halfcyl){
-        AddFinalZone_Var(vec[0],silovec[0],dims);
-        AddFinalZone_Var(vec[1],silovec[1],dims);  
-        AddFinalZone_Var(vec[2],silovec[2],dims);  
-    }else
-        // Add the SILO ghost zones to the data:
-        AddGhostZones_Var(vec[0],silovec[0],dims);
-        AddGhostZones_Var(vec[1],silovec[1],dims);
-        AddGhostZones_Var(vec[2],silovec[2],dims);
-    }
-    // Convert to Cartesian vector components:
-    Cyl_to_Cart(silovec,s,dims);
-    // Remove nonzero elements below a threshold (e.g. 1e-10):
-    Ntot = silodims[0]*silodims[1]*silodims[2];
-    Set_Zeros(silovec[0],Ntot);
-    Set_Zeros(silovec[1],Ntot);
-    Set_Zeros(silovec[2],Ntot);
-    // Write the vector to the .silo file:
-    DBPutQuadvar(dbfile, vname, mesh_name, ndims, varnames, silovec, silodims,
-                 ndims, NULL, 0, DB_FLOAT, DB_NODECENT, NULL);    
-    for(int m=0; m<ndims; m++) { delete [] silovec[m]; }
+void SILO_CycObj::Load_Series_Table(void) {
+    // Reloads the root time table of an existing container so that the 
+    // cycles of earlier runs stay in the table
+    DBSetDir(series_dbfile,"/");
+    if(!DBInqVarExists(series_dbfile,"cycles") || 
+       !DBInqVarExists(series_dbfile,"times"))
+        return;
+    int n = DBGetVarLength(series_dbfile,"cycles");
+    if(n <= 0 || DBGetVarLength(series_dbfile,"times") != n)
+        return;
+    series_cycles = new int[n];
+    series_times = new double[n];
+    DBReadVar(series_dbfile,"cycles",series_cycles);
+    DBReadVar(series_dbfile,"times",series_times);
+    Nseries = n;
+    series_capacity = n;
 }
 
 //============================================================================//
-void AddGhostZones_Coord(float *s, float *&s_ghost, int &Ns) {
-    int k, kshift;
-    // Add the ghost zones in phi for mesh continuity:
-    Ns += 2*Nghost + 1;
-    s_ghost = new float[Ns];    
-    kshift = Ns - (2*Nghost+1);
-    for(k=Nghost; k<(Ns-Nghost-1); k++) {
-        s_ghost[k] = s[k-Nghost];
-        // Make periodicity continuous and add upper ghost zones:
-        if(k <= (2*Nghost))
-            s_ghost[k+kshift] = s_ghost[k];
-        // Add lower ghost zones:
-        if(k >= (Ns-(2*Nghost+1)))
-            s_ghost[k-kshift] = s_ghost[k];
+bool SILO_CycObj::Series_Has_Dir(char *cycle_dir) {
+    // Returns true if the open container has the directory cycle_dir
+    DBSetDir(series_dbfile,"/");
+    DBtoc *dbtoc = DBGetToc(series_dbfile);
+    if(dbtoc == NULL)
+        return false;
+    for(int m=0; m<dbtoc->ndir; m++) {
+        if(strcmp(dbtoc->dir_names[m],cycle_dir) == 0)
+            return true;
     }
+    return false;
 }
 
 //============================================================================//
-void AddGhostZones_Var(float *var, float *&silovar, int *dims) {
-    // Add the SILO ghost zones (in phi) to the variable
-    int nshift, Ntot, n;
-    int Nq = dims[0], Nr = dims[1], Ns = dims[2] + 2*Nghost + 1;
-    
-    Ntot = Nq*Nr*Ns;
-    silovar = new float[Ntot];
-    nshift = Ntot - (2*Nghost+1)*Nq*Nr;
-    n = Nghost*Nq*Nr;
-    for(int k=Nghost; k<(Ns-Nghost-1); k++) {
-        for(int j=0; j<Nr; j++) {
-            for(int i=0; i<Nq; i++) {
-                silovar[n] = var[n-Nghost*Nq*Nr]; 
-                // Continuous periodicity/ghost zones at top of mesh:
-                if(k < (2*Nghost+1))
-                    silovar[n+nshift] = silovar[n];
-                // Ghost zones at the bottom of the mesh:
-                if(k >= (Ns-(2*Nghost+1)))
-                    silovar[n-nshift] = silovar[n];
-                n++;                
-            }
+void SILO_CycObj::Add_Series_Entry(int cycle, double time) {
+    // Appends a cycle to the time table of the container (the table doubles
+    // in size when it is full) and rewrites the root table on disk, so that
+    // a run that is stopped before Close_Series still leaves a valid table
+    if(Nseries == series_capacity) {
+        int capacity = (series_capacity > 0) ? 2*series_capacity : 16;
+        int *cycles = new int[capacity];
+        double *times = new double[capacity];
+        for(int m=0; m<Nseries; m++) {
+            cycles[m] = series_cycles[m];
+            times[m] = series_times[m];
         }
+        delete [] series_cycles;
+        delete [] series_times;
+        series_cycles = cycles;
+        series_times = times;
+        series_capacity = capacity;
     }
+    series_cycles[Nseries] = cycle;
+    series_times[Nseries] = time;
+    Nseries++;
+    Write_Series_Table();
 }
 
 //============================================================================//
-void AddFinalZone_Var(float *var, float *&silovar, int *dims) {
-    // Add the SILO ghost zones (in phi) to the variable
-    int nshift, Ntot, n;
-    int Nq = dims[0], Nr = dims[1], Ns = dims[2] + 2*Nghost + 1;
-    
-    Ntot = Nq*Nr*Ns;
-    silovar = new float[Ntot];
-    nshift = Ntot - (2*Nghost+1)*Nq*Nr;
-    n = Nghost*Nq*Nr;
-    for(int k=Nghost; k<(Ns-Nghost-1); k++) {
-        for(int j=0; j<Nr; j++) {
-            for(int i=0; i<Nq; i++) {
-                silovar[n] = var[n-Nghost*Nq*Nr]; 
-                // Continuous periodicity/ghost zones at top of mesh:
-                if(k < (2*Nghost+1))
-                    silovar[n+nshift] = silovar[n];
-                // Ghost zones at the bottom of the mesh:
-                if(k >= (Ns-(2*Nghost+1)))
-                    silovar[n-nshift] = silovar[n];
-                n++;                
-            }
-        }
-    }
+void SILO_CycObj::Write_Series_Table(void) {
+    // Writes the root time table ("cycles" and "times") of the container 
+    // over the previous one and flushes the container to disk
+    if(series_dbfile == NULL || Nseries == 0)
+        return;
+    DBSetDir(series_dbfile,"/");
+    int allow = DBSetAllowOverwrites(1);
+    DBWrite(series_dbfile,"cycles",series_cycles,&Nseries,1,DB_INT);
+    DBWrite(series_dbfile,"times",series_times,&Nseries,1,DB_DOUBLE);
+    DBSetAllowOverwrites(allow);
+    DBFlush(series_dbfile);
 }
 
 //============================================================================//
-void Cyl_to_Cart(float **vec, float *s, int *dims) {
-    // Add functionality comment here
-    int i, j, k, n, Ntot;
-    int Nq = dims[0], Nr = dims[1], Ns = dims[2];
-    float *vec_q = vec[0], *vec_r = vec[1], *vec_s = vec[2];
-    float *vec_x=NULL, *vec_y=NULL, *s_ghost=NULL;
-    
-    AddGhostZones_Coord(s,s_ghost,Ns);
-    Ntot = Nq*Nr*Ns;
-    vec_x = new float[Ntot];
-    vec_y = new float[Ntot];
-    
-    // Convert (r,phi) components to (x,y) components
-    n = 0;
-    for(k=0; k<Ns; k++) {
-        for(j=0; j<Nr; j++) {
-            for(i=0; i<Nq; i++) {
-                vec_x[n] = vec_r[n]*cos(s_ghost[k]) - vec_s[n]*sin(s_ghost[k]);
-                vec_y[n] = vec_r[n]*sin(s_ghost[k]) + vec_s[n]*cos(s_ghost[k]);
-                n++;
-            }
-        }
-    }
-    //set exclude origin in HYM_SILO.hpp
-    if(exclude_origin){
-        // Interpolate on axis at r=0
-        for(i=0; i<Nq; i++) {
-            int nsum=0;
-            float vec_x_sum=0., vec_y_sum=0.;
-            for(k=Nghost; k<(Ns-Nghost-1); k++) {
-                n = fn(i,1,k,Nq,Nr);
-                vec_x_sum += vec_x[n];
-                vec_y_sum += vec_y[n];
-                nsum++;
-            }
-            for(k=0; k<Ns; k++) {
-                n = fn(i,0,k,Nq,Nr); 
-                vec_x[n] = vec_x_sum/nsum;
-                vec_y[n] = vec_y_sum/nsum;
+void SILO_CycObj::Add_Time_Index(char *silo_path, int cycle, double time) {
+    // Appends the time of a written cycle to the time index of silo_path so 
+    // that the readers can scan the times without opening each database 
+    // (a rewritten cycle is appended again and its last entry is current).
+    // The first write of the session rewrites the index with one entry per
+    // cycle whose database (or container directory) is still on disk, so 
+    // that it does not grow over repeated runs.
+    char full_name[1001], db_name[1001];
+    struct stat fstats;
+    sprintf(full_name,"%s%s",silo_path,time_index);
+    FILE *fp = NULL;
+    if(indexed_paths.insert(std::string(full_name)).second) {
+        std::map<int,double> entries;
+        std::map<int,double>::iterator it;
+        int cyc;
+        double t;
+        fp = fopen(full_name,"r");
+        if(fp != NULL) {
+            while(fscanf(fp,"%d %lf",&cyc,&t) == 2) {
+                if(series) {
+                    sprintf(db_name,"%s_%03d",silo_name,cyc);
+                    if(Series_Has_Dir(db_name))
+                        entries[cyc] = t;
+                }
+                else {
+                    sprintf(db_name,"%s%s_%03d.silo",silo_path,silo_name,cyc);
+                    if(stat(db_name,&fstats) == 0)
+                        entries[cyc] = t;
+                }
             }
+            fclose(fp);
         }
+        entries[cycle] = time;
+        fp = fopen(full_name,"w");
+        if(fp == NULL)
+            return;
+        for(it=entries.begin(); it!=entries.end(); it++)
+            fprintf(fp,"%6d %24.16e\n",it->first,it->second);
+        fclose(fp);
+        return;
     }
-    
-    // Replace and sort the vector components into the (x,y,z) arrangement
-    delete [] vec_r; delete [] vec_s; delete [] s_ghost;
-    vec[0] = vec_x;
-    vec[1] = vec_y;
-    vec[2] = vec_q;
+    fp = fopen(full_name,"a");
+    if(fp == NULL)
+        return;
+    fprintf(fp,"%6d %24.16e\n",cycle,time);
+    fclose(fp);
 }
 
 //============================================================================//
-void Set_Zeros(float *var, int Ntot) {
-    float dum;
-    for(int n=0; n<Ntot; n++) {
-        if(var[n] < 0)
-            dum = -var[n];
-        else
-            dum = var[n];
-        if(dum < zero_threshold)
-            var[n] = 0.0;
+void SILO_CycObj::Close_Series(void) {
+    // Closes the time-series container (the root time table is already 
+    // current, see Add_Series_Entry)
+    if(series_dbfile == NULL)
+        return;
+    {
+        StageTimer timer(stage_close,0);
+        DBClose(series_dbfile);
     }
+    series_dbfile = NULL;
+    delete [] series_cycles;
+    delete [] series_times;
+    series_cycles = NULL;
+    series_times = NULL;
+    Nseries = 0;
+    series_capacity = 0;
+}
+
+//============================================================================//
+void SILO_CycObj::Write_ASCII(char *ascii_path) {
+    VerifyPath(ascii_path,stopmsg);
+    for(int m=0; m<nvars; m++) {
+        if(this-mask_flags[m]) {
+            this->data_objs[m]->WriteData_ASCII(ascii_path,this->cycle,
+                                                this->time,this->mesh_coords);
+        }
+    }                 
 }
 
 //============================================================================//
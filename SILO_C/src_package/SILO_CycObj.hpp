@@ -4,12 +4,18 @@
 Clayton Myers
 SILO_CycleObj.cpp
 Created:  06 February 2010
-Modified: 06 February 2010
+Modified: 17 October 2026
 
 Header file for SILO cycle objects.
 
 */
 //============================================================================//
+//============================================================================//
+
+#include <map>
+#include <set>
+#include <string>
+
 //============================================================================//
 class SILO_CycObj {
     public:
@@ -20,24 +26,65 @@ class SILO_CycObj {
         bool report_flag;        // Flagged if this database requires a report
         bool write_flag;         // Flagged if this database should be written
         bool mask_flags[nvars];  // Mask array for writing each data member
+        static bool shared_mesh; // Write the mesh once to a shared mesh file
+        static bool series;      // Write all cycles into one container file
+        static long mem_budget;  // Bytes for a streamed block (0 = off)
         
     protected:
-        int *silodims;               // Dimensions of mesh for SILO output
+        int *dims;               // Dimensions of the stripped HYM mesh
         float **mesh_coords;     // Coordinates of the HYM mesh
+        float *vals[nvars][ndims]; // Data for each variable between stages
+        int task_vars[nvars];    // Indices of the variables to convert
+        int Ntasks;              // Number of variables to convert
         char *stopmsg;           // Customizable error message
         HYMDataObj **data_objs;  // Vector of HYM data objects
+        
+        // Cartesian mesh shared by all cycles of the conversion session:
+        static float **mesh_src;              // Mesh the cache was built from
+        static float *mesh_cache[ndims];      // Ghosted (x,y,z) coordinates
+        static int mesh_cache_dims[ndims];    // Dimensions of the cached mesh
+        static int *mesh_src_dims;            // Stripped dimensions of mesh_src
+        static bool mesh_file_written;        // Shared mesh file is complete
+        
+        // Time-series container shared by all cycles (see series):
+        static DBfile *series_dbfile;         // Open container (or NULL)
+        static int Nseries;                   // Number of cycles written
+        static int series_capacity;           // Allocated table length
+        static int *series_cycles;            // Cycle of each directory
+        static double *series_times;          // Time of each directory
+        
+        // Time indexes compacted in this session (see Add_Time_Index):
+        static std::set<std::string> indexed_paths;
 
     public:
         SILO_CycObj(int,float**,int*,HYMDataObj**,bool*,char*);
         ~SILO_CycObj(void);
         void Write_SILO(char*);
         void Write_ASCII(char*);
+        void Read_Data(void);
+        void Transform_Data(void);
+        void Put_SILO(char*);
+        void Free_Data(void);
+        static void Free_Mesh(void);
+        static void Close_Series(void);
         
     protected:
         static void StripGhostCoords(double*,float*&,int,int,int);
         static bool CompareMeshDims(int*,int*,char*,char*);
         void SetFlags(bool*);
         void SetTime(void);
+        static void Read_Task(int,void*);
+        static void Transform_Task(int,void*);
+        static void Build_Mesh(float**,int*);
+        static void Write_Mesh_File(char*);
+        static void Put_Mesh_Block(DBfile*,int,int,double);
+        void Put_Blocks(DBfile*);
+        static DBfile *Open_Series(char*,char*);
+        static void Load_Series_Table(void);
+        static bool Series_Has_Dir(char*);
+        static void Add_Series_Entry(int,double);
+        static void Write_Series_Table(void);
+        static void Add_Time_Index(char*,int,double);
 };
 
 //============================================================================//
@@ -0,0 +1,218 @@
+//============================================================================//
+/*
+
+Clayton Myers
+SILO_Pipeline.cpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Staged SILO conversion.  A reader thread loads the binary data for cycle N+1
+while a transform thread prepares cycle N and the calling thread writes cycle
+N-1.  The stages are connected by bounded queues so that at most a few cycles
+are held in memory.  All SILO library calls stay on the calling thread.
+
+With more than one worker, each worker thread reads and transforms whole 
+cycles (claimed in order from a shared counter) and hands them to the writer.
+The HYM data objects only use positional reads, so the workers never contend
+on a file position.  The SILO library is not thread-safe, so the database 
+writes themselves remain serialized on the calling thread.
+
+*/
+//============================================================================//
+//============================================================================//
+
+#include <HYM_SILO.hpp>
+#include <HYM_DataObj.hpp>
+#include <SILO_CycObj.hpp>
+#include <SILO_Pipeline.hpp>
+#include <Thread_Functions.hpp>
+
+//============================================================================//
+//============================================================================//
+struct PipeStage {
+    SILO_CycObj **cyc_objs;  // Cycle objects to convert (NULL entries skipped)
+    int Ncyc;                // Length of cyc_objs
+    CycQueue *in;            // Input queue (NULL for the reader stage)
+    CycQueue *out;           // Output queue
+    int next;                // Next cycle index to claim (worker stage)
+    int Nactive;             // Number of running workers (worker stage)
+    int budget;              // Threads available to each worker
+    pthread_mutex_t lock;    // Guards next and Nactive (worker stage)
+};
+
+void *Read_Stage(void*);
+void *Transform_Stage(void*);
+void *Work_Stage(void*);
+
+//============================================================================//
+//############################################################################//
+//============================================================================//
+CycQueue::CycQueue(int capacity) {
+    if(capacity < 1)
+        capacity = 1;
+    this->capacity = capacity;
+    this->items = new SILO_CycObj*[capacity];
+    this->head = 0;
+    this->count = 0;
+    pthread_mutex_init(&this->lock,NULL);
+    pthread_cond_init(&this->not_empty,NULL);
+    pthread_cond_init(&this->not_full,NULL);
+}
+
+//============================================================================//
+CycQueue::~CycQueue(void) {
+    pthread_cond_destroy(&this->not_full);
+    pthread_cond_destroy(&this->not_empty);
+    pthread_mutex_destroy(&this->lock);
+    delete [] this->items;
+}
+
+//============================================================================//
+void CycQueue::Push(SILO_CycObj *cyc_obj) {
+    pthread_mutex_lock(&this->lock);
+    while(this->count == this->capacity)
+        pthread_cond_wait(&this->not_full,&this->lock);
+    this->items[(this->head+this->count)%this->capacity] = cyc_obj;
+    this->count++;
+    pthread_cond_signal(&this->not_empty);
+    pthread_mutex_unlock(&this->lock);
+}
+
+//============================================================================//
+SILO_CycObj *CycQueue::Pop(void) {
+    SILO_CycObj *cyc_obj;
+    pthread_mutex_lock(&this->lock);
+    while(this->count == 0)
+        pthread_cond_wait(&this->not_empty,&this->lock);
+    cyc_obj = this->items[this->head];
+    this->head = (this->head+1)%this->capacity;
+    this->count--;
+    pthread_cond_signal(&this->not_full);
+    pthread_mutex_unlock(&this->lock);
+    return cyc_obj;
+}
+
+//============================================================================//
+//############################################################################//
+//============================================================================//
+void Run_Pipeline(SILO_CycObj **cyc_objs, int Ncyc, char *silo_path, 
+                  int depth, int Nworkers) {
+    // Converts the cycle objects with overlapping read, transform and write 
+    // stages.  depth is the capacity of each queue between the stages and 
+    // Nworkers is the number of threads that read and transform cycles.
+    if(Nworkers > 1) {
+        Run_Workers(cyc_objs,Ncyc,silo_path,depth,Nworkers);
+        return;
+    }
+    pthread_t read_thread, transform_thread;
+    CycQueue read_queue(depth), write_queue(depth);
+    PipeStage read_stage, transform_stage;
+    read_stage.cyc_objs = cyc_objs;
+    read_stage.Ncyc = Ncyc;
+    read_stage.in = NULL;
+    read_stage.out = &read_queue;
+    transform_stage = read_stage;
+    transform_stage.in = &read_queue;
+    transform_stage.out = &write_queue;
+    
+    pthread_create(&read_thread,NULL,Read_Stage,&read_stage);
+    pthread_create(&transform_thread,NULL,Transform_Stage,&transform_stage);
+    
+    // Writer stage (SILO calls stay on this thread):
+    SILO_CycObj *cyc_obj;
+    while((cyc_obj = write_queue.Pop()) != NULL)
+        cyc_obj->Put_SILO(silo_path);
+    
+    pthread_join(read_thread,NULL);
+    pthread_join(transform_thread,NULL);
+}
+
+//============================================================================//
+void Run_Workers(SILO_CycObj **cyc_objs, int Ncyc, char *silo_path, 
+                 int depth, int Nworkers) {
+    // Converts independent cycles on a pool of Nworkers threads that each read
+    // and transform a whole cycle before queueing it for the writer.
+    pthread_t *threads = new pthread_t[Nworkers];
+    CycQueue write_queue(depth);
+    PipeStage work_stage;
+    work_stage.cyc_objs = cyc_objs;
+    work_stage.Ncyc = Ncyc;
+    work_stage.in = NULL;
+    work_stage.out = &write_queue;
+    work_stage.next = 0;
+    work_stage.Nactive = Nworkers;
+    work_stage.budget = (Nthreads > Nworkers) ? Nthreads/Nworkers : 1;
+    pthread_mutex_init(&work_stage.lock,NULL);
+    
+    for(int m=0; m<Nworkers; m++)
+        pthread_create(&threads[m],NULL,Work_Stage,&work_stage);
+        
+    // Writer stage (SILO calls stay on this thread):
+    SILO_CycObj *cyc_obj;
+    while((cyc_obj = write_queue.Pop()) != NULL)
+        cyc_obj->Put_SILO(silo_path);
+    
+    for(int m=0; m<Nworkers; m++)
+        pthread_join(threads[m],NULL);
+    pthread_mutex_destroy(&work_stage.lock);
+    delete [] threads;
+}
+
+//============================================================================//
+void *Read_Stage(void *arg) {
+    PipeStage *stage = (PipeStage*)arg;
+    for(int m=0; m<stage->Ncyc; m++) {
+        if(stage->cyc_objs[m] != NULL) {
+            stage->cyc_objs[m]->Read_Data();
+            stage->out->Push(stage->cyc_objs[m]);
+        }
+    }
+    stage->out->Push(NULL);
+    return NULL;
+}
+
+//============================================================================//
+void *Transform_Stage(void *arg) {
+    PipeStage *stage = (PipeStage*)arg;
+    SILO_CycObj *cyc_obj;
+    while((cyc_obj = stage->in->Pop()) != NULL) {
+        cyc_obj->Transform_Data();
+        stage->out->Push(cyc_obj);
+    }
+    stage->out->Push(NULL);
+    return NULL;
+}
+
+//============================================================================//
+void *Work_Stage(void *arg) {
+    PipeStage *stage = (PipeStage*)arg;
+    int m;
+    // Share the slab-parallel threads between the workers:
+    Set_Thread_Budget(stage->budget);
+    while(true) {
+        // Claim the next cycle:
+        pthread_mutex_lock(&stage->lock);
+        while(stage->next < stage->Ncyc && stage->cyc_objs[stage->next] == NULL)
+            stage->next++;
+        m = stage->next;
+        if(m < stage->Ncyc)
+            stage->next++;
+        pthread_mutex_unlock(&stage->lock);
+        if(m >= stage->Ncyc)
+            break;
+        
+        stage->cyc_objs[m]->Read_Data();
+        stage->cyc_objs[m]->Transform_Data();
+        stage->out->Push(stage->cyc_objs[m]);
+    }
+    // The last worker to finish ends the stream:
+    pthread_mutex_lock(&stage->lock);
+    stage->Nactive--;
+    if(stage->Nactive == 0)
+        stage->out->Push(NULL);
+    pthread_mutex_unlock(&stage->lock);
+    return NULL;
+}
+
+//============================================================================//
+//============================================================================//
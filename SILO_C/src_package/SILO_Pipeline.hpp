@@ -0,0 +1,42 @@
+//============================================================================//
+/*
+
+Clayton Myers
+SILO_Pipeline.hpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Header file for the staged (read/transform/write) SILO conversion pipeline.
+
+*/
+//============================================================================//
+//============================================================================//
+
+#include <pthread.h>
+
+//============================================================================//
+class CycQueue {
+    // Bounded FIFO of SILO cycle objects passed between pipeline stages.  A
+    // NULL entry marks the end of the stream.
+    protected:
+        SILO_CycObj **items;     // Ring buffer of queued cycle objects
+        int capacity;            // Maximum number of queued cycle objects
+        int head;                // Index of the next object to pop
+        int count;               // Number of queued cycle objects
+        pthread_mutex_t lock;
+        pthread_cond_t not_empty;
+        pthread_cond_t not_full;
+
+    public:
+        CycQueue(int);
+        ~CycQueue(void);
+        void Push(SILO_CycObj*);
+        SILO_CycObj *Pop(void);
+};
+
+//============================================================================//
+void Run_Pipeline(SILO_CycObj**,int,char*,int,int);
+void Run_Workers(SILO_CycObj**,int,char*,int,int);
+
+//============================================================================//
+//============================================================================//
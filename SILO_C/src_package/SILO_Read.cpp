@@ -4,7 +4,7 @@
 Clayton Myers
 SILO_Read.cpp
 Created:  14 September 2009
-Modified: 16 September 2009
+Modified: 17 October 2026
 
 Support functions for reading data from existing .silo databases.
 
@@ -15,128 +15,560 @@ Support functions for reading data from existing .silo databases.
 #include <HYM_SILO.hpp>
 #include <SILO_Read.hpp>
 
+#include <dirent.h>     // For opendir and readdir in Get_Cycles
+#include <sys/stat.h>   // For stat in Exists_SILO
+#include <algorithm>    // For sort in Get_Cycles
+#include <vector>
+
 //============================================================================//
 //============================================================================//
-void GetVar_SILO(DBfile*,char*,DBquadvar*&,char*,int*,char*);
-void StripVar_SILO(DBquadvar*,float*&,int*,int);
-void Cart_to_Cyl(float**,int*);
+DBquadmesh *GetMesh_SILO(char*,DBfile*,char*,DBfile*&,char*,bool);
+DBquadmesh *GetMeshBlock_SILO(char*,DBfile*,char*,DBfile*&,char*,bool);
+DBquadmesh *GetMeshHeader_SILO(DBfile*,char*);
+DBquadmesh *GetQuadmesh_SILO(DBfile*,char*);
+bool InList_SILO(char*,char**,int);
+DBquadvar *AssembleVar_SILO(DBfile*,DBmultivar*,bool*,char*);
+int *ReadBlockIndex_SILO(DBfile*,int,int*,char*);
+DBfile *OpenSeries_SILO(char*);
+void CloseSeries_SILO(void);
+void StripVar_SILO(DBquadvar*,float*&,int*,int,bool*);
+void Cart_to_Cyl(float**,int*,bool*);
+bool ParseCycle_SILO(char*,char*,int&);
+bool Exists_SILO(char*,int);
+
+// Time-series container (see OpenFile_SILO):
+char *series_name = "HYM_series.silo";
+DBfile *series_dbfile = NULL;
+char series_path[1001] = "";
+
+// Time index of the databases in a directory (see ReadTimes_SILO):
+char *index_name = "HYM_times.dat";
+
+// Kinds of the objects in the reader table of contents:
+const int toc_qvar = 1, toc_multivar = 2, toc_qmesh = 3, toc_multimesh = 4;
+const int toc_var = 5;
 
 //============================================================================//
-void ReadScalar_SILO(char *path, char *fname, char *varname, float *&var, 
+void ReadScalar_SILO(char *path, char *fname, char *varname, float *&var,
                      int *dims, char *stopmsg) {
     // Function to read a scalar variable from an existing .silo database
-    DBfile *dbfile=NULL;
-    OpenFile_SILO(path,fname,dbfile,stopmsg);
-    
-    DBquadvar *dbvar=NULL;
-    GetVar_SILO(dbfile,varname,dbvar,"scalar",dims,stopmsg);        
-    StripVar_SILO(dbvar,var,dims,0);
-     
-    DBFreeQuadvar(dbvar);
-    DBClose(dbfile);
+    SILO_Reader reader(path,fname,"HYM_mesh",stopmsg);
+    var = NULL;
+    reader.ReadScalar(varname,var,dims);
 }
 
 //============================================================================//
 void ReadVector_SILO(char *path, char *fname, char *varname, float **vec,
                      int *dims, char *stopmsg) {
     // Function to read a vector variable from an existing .silo database
-    DBfile *dbfile=NULL;
-    OpenFile_SILO(path,fname,dbfile,stopmsg);
-    
-    DBquadvar *dbvar=NULL;
-    GetVar_SILO(dbfile,varname,dbvar,"vector",dims,stopmsg);        
-    StripVar_SILO(dbvar,vec[0],dims,0);
-    StripVar_SILO(dbvar,vec[1],dims,1);
-    StripVar_SILO(dbvar,vec[2],dims,2);
-    
-    Cart_to_Cyl(vec,dims);
-    
-    DBFreeQuadvar(dbvar);
-    DBClose(dbfile);                     
+    SILO_Reader reader(path,fname,"HYM_mesh",stopmsg);
+    for(int m=0; m<ndims; m++)
+        vec[m] = NULL;
+    reader.ReadVector(varname,vec,dims);
 }
 
 //============================================================================//
 double ReadTime_SILO(char *path, char *fname, char *mesh_name, char *stopmsg) {
-    DBfile *dbfile=NULL;
-    OpenFile_SILO(path,fname,dbfile,stopmsg);
-    double time;
-        
-    DBquadmesh *dbmesh=NULL;
-    dbmesh = DBGetQuadmesh(dbfile,mesh_name);
+    SILO_Reader reader(path,fname,mesh_name,stopmsg);
+    return reader.Time();
+}
+
+//============================================================================//
+//############################################################################//
+//============================================================================//
+SILO_Reader::SILO_Reader(char *path, char *fname, char *mesh_name,
+                         char *stopmsg) {
+    this->path = path;
+    this->mesh_name = mesh_name;
+    this->stopmsg = stopmsg;
+    this->meta_loaded = false;
+    this->dims_loaded = false;
+    this->time = 0.0;
+    this->cycle = 0;
+
+    OpenFile_SILO(path,fname,this->dbfile,stopmsg);
+    // Remember the directory (the time-series container is shared):
+    DBGetDir(this->dbfile,this->dir);
+
+    // Cache the table of contents:
+    DBtoc *dbtoc = DBGetToc(this->dbfile);
+    for(int i=0; i<dbtoc->nqvar; i++)
+        this->toc[dbtoc->qvar_names[i]] = toc_qvar;
+    for(int i=0; i<dbtoc->nmultivar; i++)
+        this->toc[dbtoc->multivar_names[i]] = toc_multivar;
+    for(int i=0; i<dbtoc->nqmesh; i++)
+        this->toc[dbtoc->qmesh_names[i]] = toc_qmesh;
+    for(int i=0; i<dbtoc->nmultimesh; i++)
+        this->toc[dbtoc->multimesh_names[i]] = toc_multimesh;
+    for(int i=0; i<dbtoc->nvar; i++)
+        this->toc[dbtoc->var_names[i]] = toc_var;
+    this->cyl_components = (this->Kind("cyl_components") == toc_var);
+}
+
+//============================================================================//
+SILO_Reader::~SILO_Reader(void) {
+    CloseFile_SILO(this->dbfile);
+}
+
+//============================================================================//
+int SILO_Reader::Kind(char *name) {
+    // Returns the kind of the named object in the database (0 if absent)
+    map<string,int>::iterator entry = this->toc.find(name);
+    return (entry == this->toc.end()) ? 0 : entry->second;
+}
+
+//============================================================================//
+void SILO_Reader::Select(void) {
+    // Returns to the directory of this database (another reader of the
+    // time-series container may have moved it)
+    if(this->dbfile == series_dbfile)
+        DBSetDir(this->dbfile,this->dir);
+}
+
+//============================================================================//
+double SILO_Reader::Time(void) {
+    this->LoadMeta();
+    return this->time;
+}
+
+//============================================================================//
+int SILO_Reader::Cycle(void) {
+    this->LoadMeta();
+    return this->cycle;
+}
+
+//============================================================================//
+void SILO_Reader::LoadMeta(void) {
+    // Loads the time and cycle of the database (once)
+    if(this->meta_loaded)
+        return;
+    this->Select();
+    if(this->Kind("dtime") == toc_var) {
+        // The time and cycle are stored directly (without the mesh):
+        DBReadVar(this->dbfile,"dtime",&this->time);
+        if(this->Kind("cycle") == toc_var)
+            DBReadVar(this->dbfile,"cycle",&this->cycle);
+    }
+    else {
+        // Older databases only hold the time and cycle in the mesh header:
+        DBquadmesh *dbmesh = GetMeshHeader_SILO(this->dbfile,this->mesh_name);
+        if(dbmesh == NULL) {
+            char message[1001];
+            sprintf(message,"  Unable to locate the mesh \"%s\" %s\n  %s",
+                    this->mesh_name,"in the .silo database.",this->stopmsg);
+            StopExecution(message);
+        }
+        this->time = dbmesh->dtime;
+        this->cycle = dbmesh->cycle;
+        DBFreeQuadmesh(dbmesh);
+    }
+    this->meta_loaded = true;
+}
+
+//============================================================================//
+void SILO_Reader::GetMeshDims(int *dims) {
+    // Gets the stripped dimensions of the mesh (cached after the first call)
+    if(!this->dims_loaded) {
+        this->Select();
+        if(this->Kind(this->mesh_name) == toc_multimesh) {
+            DBmultimesh *dbmultimesh = DBGetMultimesh(this->dbfile,
+                                                      this->mesh_name);
+            int Nblocks = dbmultimesh->nblocks;
+            DBFreeMultimesh(dbmultimesh);
+            // Multi-block databases record the full dimensions with the blocks:
+            if(Nblocks > 1) {
+                delete [] ReadBlockIndex_SILO(this->dbfile,Nblocks,
+                                              this->mesh_dims,this->stopmsg);
+                this->dims_loaded = true;
+            }
+        }
+        if(!this->dims_loaded) {
+            DBfile *meshfile = NULL;
+            DBquadmesh *dbquadmesh = GetMesh_SILO(this->path,this->dbfile,
+                                                  this->mesh_name,meshfile,
+                                                  this->stopmsg,true);
+            if(dbquadmesh == NULL) {
+                char message[1001];
+                sprintf(message,"  Unable to locate the mesh \"%s\" %s\n  %s",
+                        this->mesh_name,"in the .silo database.",
+                        this->stopmsg);
+                StopExecution(message);
+            }
+            for(int m=0; m<ndims; m++)
+                this->mesh_dims[m] = dbquadmesh->dims[m];
+            DBFreeQuadmesh(dbquadmesh);
+            if(meshfile != NULL)
+                DBClose(meshfile);
+            this->dims_loaded = true;
+        }
+        this->mesh_dims[2] = this->mesh_dims[2] - (2*Nghost+1);
+    }
+    for(int m=0; m<ndims; m++)
+        dims[m] = this->mesh_dims[m];
+}
+
+//============================================================================//
+void SILO_Reader::GetMeshCoords(float **coords) {
+    // Gets the node coordinates (z, r and phi) of the stripped mesh as new 
+    // arrays.  z and r are read from the mesh (from every block of a 
+    // multi-block database).  phi is read from a collinear (--cyl) mesh and is
+    // otherwise the uniform angle of Construct_Phi (as in Cart_to_Cyl).
+    int dims[ndims], lo[ndims] = {0,0,0}, Nblocks = 1, gdims[ndims];
+    int *block_index = NULL;
+    bool collinear = false;
+    DBmultimesh *dbmultimesh = NULL;
     
-    time = dbmesh->dtime;
+    this->GetMeshDims(dims);
+    for(int m=0; m<ndims; m++)
+        coords[m] = new float[dims[m]];
+    this->Select();
+    if(this->Kind(this->mesh_name) == toc_multimesh) {
+        dbmultimesh = DBGetMultimesh(this->dbfile,this->mesh_name);
+        Nblocks = dbmultimesh->nblocks;
+        if(Nblocks > 1)
+            block_index = ReadBlockIndex_SILO(this->dbfile,Nblocks,gdims,
+                                              this->stopmsg);
+    }
     
-    DBFreeQuadmesh(dbmesh);
-    DBClose(dbfile);
+    for(int b=0; b<Nblocks; b++) {
+        DBfile *meshfile = NULL;
+        DBquadmesh *dbquadmesh = NULL;
+        if(Nblocks > 1) {
+            dbquadmesh = GetMeshBlock_SILO(this->path,this->dbfile,
+                                           dbmultimesh->meshnames[b],meshfile,
+                                           this->stopmsg,false);
+            for(int m=0; m<ndims; m++)
+                lo[m] = block_index[2*ndims*b+m];
+        }
+        else
+            dbquadmesh = GetMesh_SILO(this->path,this->dbfile,this->mesh_name,
+                                      meshfile,this->stopmsg,false);
+        if(dbquadmesh == NULL) {
+            char message[1001];
+            sprintf(message,"  Unable to locate the mesh \"%s\" %s\n  %s",
+                    this->mesh_name,"in the .silo database.",this->stopmsg);
+            StopExecution(message);
+        }
+        
+        // Collinear meshes hold the coordinate vectors; Cartesian meshes 
+        // give z and r along the first row and column of the first plane:
+        int Nq = dbquadmesh->dims[0], Nr = dbquadmesh->dims[1];
+        float **c = dbquadmesh->coords;
+        collinear = (dbquadmesh->coordtype == DB_COLLINEAR);
+        for(int i=0; i<Nq; i++)
+            coords[0][lo[0]+i] = collinear ? c[0][i] : c[2][fn(i,0,0,Nq,Nr)];
+        for(int j=0; j<Nr; j++) {
+            if(collinear)
+                coords[1][lo[1]+j] = c[1][j];
+            else {
+                int n = fn(0,j,0,Nq,Nr);
+                coords[1][lo[1]+j] = sqrt(c[0][n]*c[0][n] + c[1][n]*c[1][n]);
+            }
+        }
+        if(collinear) {
+            for(int k=0; k<dbquadmesh->dims[2]; k++) {
+                int ks = lo[2] + k - Nghost;
+                if(ks >= 0 && ks < dims[2])
+                    coords[2][ks] = c[2][k];
+            }
+        }
+        DBFreeQuadmesh(dbquadmesh);
+        if(meshfile != NULL)
+            DBClose(meshfile);
+    }
     
-    return time;
+    if(dbmultimesh != NULL)
+        DBFreeMultimesh(dbmultimesh);
+    if(block_index != NULL)
+        delete [] block_index;
+    if(!collinear) {
+        delete [] coords[2];
+        Construct_Phi(coords[2],dims);
+    }
 }
 
 //============================================================================//
+void SILO_Reader::ReadScalar(char *varname, float *&var, int *dims) {
+    // Reads a scalar variable with the ghost zones stripped.  If var is not
+    // NULL it must hold the stripped variable; otherwise it is allocated.
+    DBquadvar *dbvar = this->GetVar(varname,1,dims,NULL);
+    StripVar_SILO(dbvar,var,dims,0,NULL);
+    DBFreeQuadvar(dbvar);
+}
+
 //============================================================================//
-void GetVar_SILO(DBfile *dbfile, char *varname, DBquadvar *&dbvar, 
-                 char *nvals_str, int *dims, char *stopmsg) {
+void SILO_Reader::ReadVector(char *varname, float **vec, int *dims) {
+    // Reads a vector variable with the ghost zones stripped into its (z,r,phi)
+    // components.  Non-NULL components of vec must hold the stripped variable;
+    // the others are allocated.
+    this->ReadVectorPlanes(varname,NULL,vec,dims);
+}
+
+//============================================================================//
+void SILO_Reader::ReadVectorPlanes(char *varname, bool *planes, float **vec,
+                                   int *dims) {
+    // As ReadVector, but only the stripped phi planes k with planes[k] set are
+    // filled (all of them if planes is NULL).  The blocks of a multi-block
+    // variable holding none of those planes are not read; the other planes of
+    // vec are left unspecified.
+    DBquadvar *dbvar = this->GetVar(varname,3,dims,planes);
+    StripVar_SILO(dbvar,vec[0],dims,0,planes);
+    StripVar_SILO(dbvar,vec[1],dims,1,planes);
+    StripVar_SILO(dbvar,vec[2],dims,2,planes);
+    DBFreeQuadvar(dbvar);
+
+    // Vectors written in their (z,r,phi) components need no conversion:
+    if(!this->cyl_components)
+        Cart_to_Cyl(vec,dims,planes);
+}
+
+//============================================================================//
+DBquadvar *SILO_Reader::GetVar(char *varname, int nvals, int *dims, 
+                               bool *planes) {
     // Function to retrieve variable from .silo database with error checking
-    char message[1001];    
-    // Check whether the variable requested exists in the .silo database
-    DBtoc *dbtoc = DBGetToc(dbfile);
-    bool present = false;
-    for(int i=0; i<dbtoc->nqvar; i++) {
-        if(strcmp(varname,dbtoc->qvar_names[i]) == 0)
-            present = true;
+    // (planes selects the blocks of a multi-block variable; see 
+    // AssembleVar_SILO)
+    char message[1001];
+    DBquadvar *dbvar = NULL;
+    this->Select();
+    int kind = this->Kind(varname);
+    if(kind == toc_multivar) {
+        // Variables stored as a multivar of one block or of several blocks
+        // (which are reassembled into a single quadvar):
+        DBmultivar *dbmultivar = DBGetMultivar(this->dbfile,varname);
+        if(dbmultivar->nvars > 1)
+            dbvar = AssembleVar_SILO(this->dbfile,dbmultivar,planes,
+                                     this->stopmsg);
+        else
+            dbvar = DBGetQuadvar(this->dbfile,dbmultivar->varnames[0]);
+        DBFreeMultivar(dbmultivar);
     }
-    // Stop execution if the variable requested does not exist in the database
-    if(!present) {
+    else if(kind == toc_qvar)
+        dbvar = DBGetQuadvar(this->dbfile,varname);
+    else {
+        // Stop execution if the variable requested does not exist
         sprintf(message,"  The variable \"%s\" %s\n  %s",varname,
-                "was not found in the .silo database.",stopmsg);
+                "was not found in the .silo database.",this->stopmsg);
         StopExecution(message);
     }
-    // Get the variable
-    dbvar = DBGetQuadvar(dbfile,varname);    
-    // Stop execution if a variable of improper rank is requested
-    int nvals;
-    if(strcmp(nvals_str,"scalar") == 0)
-        nvals = 1;
-    else if(strcmp(nvals_str,"vector") == 0)
-        nvals = 3;
-    else
-        nvals = 0;
-    if(dbvar->nvals != nvals) {
-        sprintf(message,"  The variable \"%s\" %s\n  %s%d\n  %s%d\n  %s",
-                varname,"does not have the proper rank.","  Requested rank: ",
-                nvals,"  Variable rank:  ",dbvar->nvals,stopmsg);
-        StopExecution(message);    
-    } 
     // Stop execution if the variable access call fails
     if(dbvar == NULL) {
         sprintf(message,"  %s \"%s\" %s\n  %s",
                 "The call to access the variable",varname,
-                "failed for an unknown reason.",stopmsg);
+                "failed for an unknown reason.",this->stopmsg);
         StopExecution(message);
     }
-    
+    // Stop execution if a variable of improper rank is requested
+    if(dbvar->nvals != nvals) {
+        sprintf(message,"  The variable \"%s\" %s\n  %s%d\n  %s%d\n  %s",
+                varname,"does not have the proper rank.","  Requested rank: ",
+                nvals,"  Variable rank:  ",dbvar->nvals,this->stopmsg);
+        StopExecution(message);
+    }
+
     // Transfer the dimension array values
     for(int m=0; m<ndims; m++)
         dims[m] = dbvar->dims[m];
+    return dbvar;
 }
 
 //============================================================================//
-void StripVar_SILO(DBquadvar *dbvar, float *&var, int *dims, int component) {
-    // Function to strip the ghost zones from the SILO variable
+//############################################################################//
+//============================================================================//
+DBquadmesh *GetMesh_SILO(char *path, DBfile *dbfile, char *mesh_name, 
+                         DBfile *&meshfile, char *stopmsg, bool header_only) {
+    // Function to retrieve the mesh (or only its header, without the 
+    // coordinates) from a .silo database.  A multimesh of one block refers to
+    // the mesh in a shared mesh file, which is opened as meshfile (to be 
+    // closed by the caller).
+    DBquadmesh *(*get_mesh)(DBfile*,char*) = 
+        header_only ? GetMeshHeader_SILO : GetQuadmesh_SILO;
+    meshfile = NULL;
+    DBtoc *dbtoc = DBGetToc(dbfile);
+    if(!InList_SILO(mesh_name,dbtoc->multimesh_names,dbtoc->nmultimesh))
+        return get_mesh(dbfile,mesh_name);
+    
+    char block_name[1001];
+    DBmultimesh *dbmultimesh = DBGetMultimesh(dbfile,mesh_name);
+    strcpy(block_name,dbmultimesh->meshnames[0]);
+    DBFreeMultimesh(dbmultimesh);
+    return GetMeshBlock_SILO(path,dbfile,block_name,meshfile,stopmsg,
+                             header_only);
+}
+
+//============================================================================//
+DBquadmesh *GetMeshBlock_SILO(char *path, DBfile *dbfile, char *block_name,
+                              DBfile *&meshfile, char *stopmsg, 
+                              bool header_only) {
+    // Retrieves one block of a multimesh.  A block name of the form 
+    // "file:/object" (e.g. a block of the shared mesh file) is read from that
+    // file, which is opened as meshfile (to be closed by the caller).
+    DBquadmesh *(*get_mesh)(DBfile*,char*) = 
+        header_only ? GetMeshHeader_SILO : GetQuadmesh_SILO;
+    char file_name[1001], *obj_name;
+    meshfile = NULL;
+    strcpy(file_name,block_name);
+    obj_name = strchr(file_name,':');
+    if(obj_name == NULL)
+        return get_mesh(dbfile,file_name);
+    *obj_name = '\0';
+    obj_name++;
+    OpenFile_SILO(path,file_name,meshfile,stopmsg);
+    return get_mesh(meshfile,obj_name);
+}
+
+//============================================================================//
+DBquadmesh *GetQuadmesh_SILO(DBfile *dbfile, char *mesh_name) {
+    // Reads a quad mesh with its coordinate arrays
+    return DBGetQuadmesh(dbfile,mesh_name);
+}
+
+//============================================================================//
+DBquadmesh *GetMeshHeader_SILO(DBfile *dbfile, char *mesh_name) {
+    // Reads the dimensions, time and cycle of a quad mesh without its 
+    // coordinate arrays (the coords of the returned mesh are not loaded)
+    unsigned long mask = DBSetDataReadMask(DBNone);
+    DBquadmesh *dbquadmesh = DBGetQuadmesh(dbfile,mesh_name);
+    DBSetDataReadMask(mask);
+    return dbquadmesh;
+}
+
+//============================================================================//
+DBquadvar *AssembleVar_SILO(DBfile *dbfile, DBmultivar *dbmultivar, 
+                            bool *planes, char *stopmsg) {
+    // Reads the blocks of a multi-block variable and copies them into a single
+    // quadvar with the full dimensions (see PutBlockIndex_SILO).  The index 
+    // limits of the first and last blocks carry over to the full variable.
+    // If planes is not NULL, only the blocks holding a stripped phi plane k 
+    // with planes[k] set are read (the headers of the others still give the
+    // index limits) and the values of the other planes are left unspecified.
+    int Nblocks = dbmultivar->nvars, gdims[ndims], *lo, *hi;
+    int *block_index = ReadBlockIndex_SILO(dbfile,Nblocks,gdims,stopmsg);
+    long Ntot = (long)gdims[0]*gdims[1]*gdims[2];
+    int Ns = gdims[2] - (2*Nghost+1);
+    
+    DBquadvar *dbvar = DBAllocQuadvar();
+    for(int b=0; b<Nblocks; b++) {
+        lo = block_index + 2*ndims*b;
+        hi = lo + ndims;
+        bool needed = (planes == NULL);
+        for(int k=lo[2]-Nghost; k<hi[2]-Nghost && !needed; k++) {
+            if(k >= 0 && k < Ns && planes[k])
+                needed = true;
+        }
+        unsigned long mask = DBSetDataReadMask(needed ? DBAll : DBNone);
+        DBquadvar *dbblock = DBGetQuadvar(dbfile,dbmultivar->varnames[b]);
+        DBSetDataReadMask(mask);
+        if(dbblock == NULL) {
+            char message[1001];
+            sprintf(message,"  The variable block \"%s\" %s\n  %s",
+                    dbmultivar->varnames[b],"could not be read.",stopmsg);
+            StopExecution(message);
+        }
+        if(b == 0) {
+            dbvar->nvals = dbblock->nvals;
+            dbvar->ndims = ndims;
+            dbvar->nels = (int)Ntot;
+            dbvar->datatype = DB_FLOAT;
+            dbvar->centering = dbblock->centering;
+            dbvar->vals = (float**)malloc(dbvar->nvals*sizeof(float*));
+            for(int c=0; c<dbvar->nvals; c++)
+                dbvar->vals[c] = (float*)malloc(Ntot*sizeof(float));
+            for(int m=0; m<ndims; m++) {
+                dbvar->dims[m] = gdims[m];
+                dbvar->min_index[m] = 0;
+                dbvar->max_index[m] = gdims[m]-1;
+            }
+        }
+        // Index limits on the outer faces of the full variable:
+        for(int m=0; m<ndims; m++) {
+            if(lo[m] == 0)
+                dbvar->min_index[m] = dbblock->min_index[m];
+            if(hi[m] == gdims[m])
+                dbvar->max_index[m] = lo[m] + dbblock->max_index[m];
+        }
+        if(!needed) {
+            DBFreeQuadvar(dbblock);
+            continue;
+        }
+        // Copy the block rows into place:
+        int Nq = hi[0]-lo[0];
+        long nb = 0;
+        for(int k=lo[2]; k<hi[2]; k++) {
+            for(int j=lo[1]; j<hi[1]; j++) {
+                long n = fn(lo[0],j,k,gdims[0],gdims[1]);
+                for(int c=0; c<dbvar->nvals; c++)
+                    memcpy(dbvar->vals[c]+n,dbblock->vals[c]+nb,
+                           Nq*sizeof(float));
+                nb += Nq;
+            }
+        }
+        DBFreeQuadvar(dbblock);
+    }
+    delete [] block_index;
+    return dbvar;
+}
+
+//============================================================================//
+int *ReadBlockIndex_SILO(DBfile *dbfile, int Nblocks, int *gdims, 
+                         char *stopmsg) {
+    // Reads the node range of each block of a multi-block database and the 
+    // full dimensions gdims that they cover
+    if(!DBInqVarExists(dbfile,"block_index") || 
+       DBGetVarLength(dbfile,"block_index") != 2*ndims*Nblocks) {
+        char message[1001];
+        sprintf(message,"  %s\n  %s",
+                "The block layout of the .silo database is missing.",stopmsg);
+        StopExecution(message);
+    }
+    int *block_index = new int[2*ndims*Nblocks];
+    DBReadVar(dbfile,"block_index",block_index);
+    for(int m=0; m<ndims; m++) {
+        gdims[m] = 0;
+        for(int b=0; b<Nblocks; b++) {
+            if(block_index[2*ndims*b+ndims+m] > gdims[m])
+                gdims[m] = block_index[2*ndims*b+ndims+m];
+        }
+    }
+    return block_index;
+}
+
+//============================================================================//
+bool InList_SILO(char *name, char **names, int nnames) {
+    // Checks for name in a table of contents list
+    for(int i=0; i<nnames; i++) {
+        if(strcmp(name,names[i]) == 0)
+            return true;
+    }
+    return false;
+}
+
+//============================================================================//
+void StripVar_SILO(DBquadvar *dbvar, float *&var, int *dims, int component,
+                   bool *planes) {
+    // Function to strip the ghost zones from the SILO variable (only the 
+    // stripped phi planes k with planes[k] set are copied unless planes is
+    // NULL)
     int i,j,k,n1,n2,Ntot,min_phi,max_phi;
 
     // Calculate the stripped array dimension and allocate the new array
+    // (unless the caller supplied one)
     min_phi = dbvar->min_index[2]; // Lower ghost zone index
     max_phi = dbvar->max_index[2]; // Upper ghost zone index
     dims[2] = max_phi-min_phi-1;
     Ntot = dims[0]*dims[1]*dims[2];
-    var = new float[Ntot];
+    if(var == NULL)
+        var = new float[Ntot];
     
     // Transfer the values between the arrays
     // n1: counter for stripped array
     // n2: counter for unstripped array
     n1 = 0;
     for(k=min_phi; k<(max_phi-1); k++) {
+        if(planes != NULL && !planes[k-min_phi]) {
+            n1 += dims[0]*dims[1];
+            continue;
+        }
         for(j=0; j<dims[1]; j++) {
             for(i=0; i<dims[0]; i++) {
                 n2 = fn(i,j,k,dims[0],dims[1]);
@@ -148,52 +580,70 @@ void StripVar_SILO(DBquadvar *dbvar, float *&var, int *dims, int component) {
 }
 
 //============================================================================//
-void Cart_to_Cyl(float **vec, int *dims) {
-    // Add functionality comment here
+void Cart_to_Cyl(float **vec, int *dims, bool *planes) {
+    // Converts the (x,y,z) components of a vector into its (z,r,phi)
+    // components in place (the arrays of vec are reused).  Only the phi planes
+    // k with planes[k] set are converted unless planes is NULL.
     int i, j, k, n;
     int Nq = dims[0], Nr = dims[1], Ns = dims[2];
-    int Ntot = Nq*Nr*Ns;
-    float *vec_x = vec[0], *vec_y = vec[1], *vec_q = vec[2], *s=NULL;
-    float *vec_r = new float[Ntot];
-    float *vec_s = new float[Ntot];
+    float x, y, q, *s=NULL;
     
     // Construct the phi vector artificially:
     Construct_Phi(s,dims);
     
-    // Convert (x,y) components to (r,s) components
+    // Convert (x,y) components to (r,s) components and sort the components
+    // into the (q,r,s) arrangement
     n = 0;
     for(k=0; k<Ns; k++) {
+        if(planes != NULL && !planes[k]) {
+            n += Nr*Nq;
+            continue;
+        }
         for(j=0; j<Nr; j++) {
             for(i=0; i<Nq; i++) {
+                x = vec[0][n]; y = vec[1][n]; q = vec[2][n];
+                vec[0][n] = q;
                 if(j == 0) {
-                    vec_r[n] = 0.0;
-                    vec_s[n] = 0.0;
+                    vec[1][n] = 0.0;
+                    vec[2][n] = 0.0;
                 }
                 else {
-                    vec_r[n] =  vec_x[n]*cos(s[k]) + vec_y[n]*sin(s[k]);
-                    vec_s[n] = -vec_x[n]*sin(s[k]) + vec_y[n]*cos(s[k]);
+                    vec[1][n] =  x*cos(s[k]) + y*sin(s[k]);
+                    vec[2][n] = -x*sin(s[k]) + y*cos(s[k]);
                 }
                 n++;
             }
         }
     }
-    
-    // Replace and sort the vector components into the (q,r,s) arrangement
-    delete [] vec_x; delete [] vec_y; delete [] s;
-    vec[0] = vec_q;
-    vec[1] = vec_r;
-    vec[2] = vec_s;
+    delete [] s;
 }
 
 //============================================================================//
 //============================================================================//
 void OpenFile_SILO(char *path, char *fname, DBfile *&dbfile, char *stopmsg) {
-    // Open an existing SILO file to read data
+    // Open an existing SILO file to read data (PDB or HDF5).  If the file does
+    // not exist but path holds a time-series container, the container is 
+    // opened once and dbfile is set to the directory named after the file
+    // (e.g. "HYM_012" for "HYM_012.silo").  Close with CloseFile_SILO.
     char fullpath[1001];
     strcpy(fullpath,path);
     strcat(fullpath,fname);
     dbfile = NULL;
-    dbfile = DBOpen(fullpath,DB_PDB,DB_APPEND);
+    if(access(fullpath,F_OK) == 0)
+        dbfile = DBOpen(fullpath,DB_UNKNOWN,DB_APPEND);
+    else if(OpenSeries_SILO(path) != NULL) {
+        char cycle_dir[1001], *ext;
+        sprintf(cycle_dir,"/%s",fname);
+        ext = strstr(cycle_dir,".silo");
+        if(ext != NULL)
+            *ext = '\0';
+        DBSetDir(series_dbfile,"/");
+        DBtoc *dbtoc = DBGetToc(series_dbfile);
+        if(InList_SILO(cycle_dir+1,dbtoc->dir_names,dbtoc->ndir)) {
+            DBSetDir(series_dbfile,cycle_dir);
+            dbfile = series_dbfile;
+        }
+    }
     if(dbfile == NULL) {
         char message[1001];
         sprintf(message,"  The SILO database \"%s\" %s\n  %s",fullpath,
@@ -202,29 +652,51 @@ void OpenFile_SILO(char *path, char *fname, DBfile *&dbfile, char *stopmsg) {
     }
 }
 
+//============================================================================//
+void CloseFile_SILO(DBfile *dbfile) {
+    // Closes a database from OpenFile_SILO (the time-series container stays
+    // open for the next cycle)
+    if(dbfile != NULL && dbfile != series_dbfile)
+        DBClose(dbfile);
+}
+
+//============================================================================//
+DBfile *OpenSeries_SILO(char *path) {
+    // Opens the time-series container in path (once per path).  Returns NULL
+    // if there is no container.
+    if(series_dbfile != NULL && strcmp(series_path,path) == 0)
+        return series_dbfile;
+    CloseSeries_SILO();
+    char fullpath[1001];
+    sprintf(fullpath,"%s%s",path,series_name);
+    if(access(fullpath,F_OK) != 0)
+        return NULL;
+    series_dbfile = DBOpen(fullpath,DB_UNKNOWN,DB_READ);
+    if(series_dbfile != NULL) {
+        strcpy(series_path,path);
+        atexit(CloseSeries_SILO);
+    }
+    return series_dbfile;
+}
+
+//============================================================================//
+void CloseSeries_SILO(void) {
+    if(series_dbfile != NULL)
+        DBClose(series_dbfile);
+    series_dbfile = NULL;
+    series_path[0] = '\0';
+}
+
 //============================================================================//
 int Get_Ncyc(char *silo_path, char *stopmsg) {
-    // Function to find the number of available cycles based on the files in the
-    // silo path directory.
-    int nlist, Ncyc, Ncyc_old;
-    char **silo_list, testname[1001];
-    
-    // Get a directory listing of the silo path:
-    listdir(silo_path,silo_list,nlist,stopmsg);
-    
-    // Iterate through the silo path to find which files exist:
+    // Function to find the number of available cycles (the cycles 1 to Ncyc
+    // are all present) based on the databases in the silo path directory.
+    int Nlist, Ncyc;
+    int *cycles = Get_Cycles(silo_path,Nlist,stopmsg);
     Ncyc = 0;
-    do {
-        Ncyc_old = Ncyc;
-        sprintf(testname,"HYM_%03d.silo",Ncyc+1);
-        for(int m=0; m<nlist; m++) {
-            // If the file is in the list, increment Ncyc:
-            if(strcmp(silo_list[m],testname) == 0)
-                Ncyc++;
-        }
-    } while(Ncyc_old != Ncyc); // Go until the file testname doesn't exist
-
-    delete [] silo_list;
+    while(Ncyc < Nlist && cycles[Ncyc] == Ncyc+1)
+        Ncyc++;
+    delete [] cycles;
     
     if(Ncyc == 0) {
         char message[1001];
@@ -238,27 +710,129 @@ int Get_Ncyc(char *silo_path, char *stopmsg) {
 }
 
 //============================================================================//
-void Get_Mesh_Dims(char *path, char *fname, char *mesh_name, int *dims, 
-                   char *stopmsg) {
-    // Function to read the dimensions of the mesh in an existing .silo database
-    char message[1001];   
-    DBfile *dbfile=NULL;
-    OpenFile_SILO(path,fname,dbfile,stopmsg);
+int *Get_Cycles(char *silo_path, int &Ncyc, char *stopmsg) {
+    // Function to find the sorted cycle numbers of the databases in the silo
+    // path directory (which may be sparse and run past 999), or of the cycle
+    // directories of a time-series container when there are no per-cycle 
+    // files.  The directory is read once.
+    vector<int> found;
+    char message[1001];
+    int cycle;
     
-    DBquadmesh *dbquadmesh=NULL;
-    dbquadmesh = DBGetQuadmesh(dbfile,mesh_name);
-    if(dbquadmesh == NULL) {
-        sprintf(message,"  Unable to locate the mesh \"%s\" %s\n  %s",mesh_name,
-                "in the .silo database.",stopmsg);
+    DIR *pdir = opendir(silo_path);
+    if(pdir == NULL) {
+        sprintf(message,"  %s%s%s\n  %s","The directory \"",silo_path,
+                "\" could not be opened.",stopmsg);
         StopExecution(message);
     }
+    struct dirent *pent = NULL;
+    while((pent = readdir(pdir)) != NULL) {
+        if(ParseCycle_SILO(pent->d_name,".silo",cycle))
+            found.push_back(cycle);
+    }
+    closedir(pdir);
     
-    for(int m=0; m<ndims; m++)
-        dims[m] = dbquadmesh->dims[m];
-    dims[2] = dims[2] - (2*Nghost+1);
+    // Otherwise list the cycle directories of a time-series container:
+    if(found.empty() && OpenSeries_SILO(silo_path) != NULL) {
+        DBSetDir(series_dbfile,"/");
+        DBtoc *dbtoc = DBGetToc(series_dbfile);
+        for(int m=0; m<dbtoc->ndir; m++) {
+            if(ParseCycle_SILO(dbtoc->dir_names[m],"",cycle))
+                found.push_back(cycle);
+        }
+    }
+    
+    if(found.empty()) {
+        sprintf(message,"  %s%s%s\n  %s",
+                "The directory \"",silo_path,
+                "\" contains no source SILO databases.",stopmsg);
+        StopExecution(message);
+    }
     
-    DBFreeQuadmesh(dbquadmesh);
-    DBClose(dbfile);
+    sort(found.begin(),found.end());
+    Ncyc = found.size();
+    int *cycles = new int[Ncyc];
+    for(int m=0; m<Ncyc; m++)
+        cycles[m] = found[m];
+    return cycles;
+}
+
+//============================================================================//
+bool ParseCycle_SILO(char *name, char *suffix, int &cycle) {
+    // Parses the cycle number from a name of the form HYM_<cycle><suffix>.  
+    // Only the names written by the converter are accepted (so that the name
+    // can be rebuilt from the cycle number).
+    char testname[1001];
+    if(strncmp(name,"HYM_",4) != 0 || strlen(name) > 64)
+        return false;
+    if(sscanf(name+4,"%d",&cycle) != 1 || cycle < 1)
+        return false;
+    sprintf(testname,"HYM_%0.3d%s",cycle,suffix);
+    return (strcmp(testname,name) == 0);
+}
+
+//============================================================================//
+double *ReadTimes_SILO(char *path, int start_cyc, int end_cyc, 
+                       char *stopmsg) {
+    // Returns the times of cycles start_cyc to end_cyc in the directory path
+    // (times[0] is start_cyc).  The times are taken from the time index 
+    // written by the converter where possible (the last entry of a cycle is
+    // the current one) and from the metadata of the remaining databases.
+    // Entries of cycles whose database is no longer on disk are skipped.
+    int Ncyc = end_cyc - start_cyc + 1;
+    double *times = new double[Ncyc], time;
+    bool *found = new bool[Ncyc];
+    char full_name[1001];
+    int cycle;
+    for(int m=0; m<Ncyc; m++)
+        found[m] = false;
+    
+    sprintf(full_name,"%s%s",path,index_name);
+    FILE *fp = fopen(full_name,"r");
+    if(fp != NULL) {
+        while(fscanf(fp,"%d %lf",&cycle,&time) == 2) {
+            if(cycle >= start_cyc && cycle <= end_cyc && 
+               Exists_SILO(path,cycle)) {
+                times[cycle-start_cyc] = time;
+                found[cycle-start_cyc] = true;
+            }
+        }
+        fclose(fp);
+    }
+    
+    for(int m=0; m<Ncyc; m++) {
+        if(!found[m]) {
+            sprintf(full_name,"HYM_%0.3d.silo",start_cyc+m);
+            times[m] = ReadTime_SILO(path,full_name,"HYM_mesh",stopmsg);
+        }
+    }
+    delete [] found;
+    return times;
+}
+
+//============================================================================//
+bool Exists_SILO(char *path, int cycle) {
+    // Checks that the database of a cycle (or its directory in the 
+    // time-series container) is present in the directory path
+    char full_name[1001];
+    struct stat fstats;
+    sprintf(full_name,"%sHYM_%03d.silo",path,cycle);
+    if(stat(full_name,&fstats) == 0)
+        return true;
+    if(OpenSeries_SILO(path) == NULL)
+        return false;
+    sprintf(full_name,"HYM_%03d",cycle);
+    DBSetDir(series_dbfile,"/");
+    DBtoc *dbtoc = DBGetToc(series_dbfile);
+    return InList_SILO(full_name,dbtoc->dir_names,dbtoc->ndir);
+}
+
+//============================================================================//
+void Get_Mesh_Dims(char *path, char *fname, char *mesh_name, int *dims, 
+                   char *stopmsg) {
+    // Function to read the dimensions of the mesh in an existing .silo database
+    SILO_Reader reader(path,fname,mesh_name,stopmsg);
+    reader.GetMeshDims(dims);
 }
 
 //============================================================================//
@@ -4,7 +4,7 @@
 Clayton Myers
 SILO_Read.hpp
 Created:  17 September 2009
-Modified: 17 September 2009
+Modified: 17 October 2026
 
 Header file for SILO read functions.
 
@@ -12,11 +12,62 @@ Header file for SILO read functions.
 //============================================================================//
 //============================================================================//
 
+#include <map>
+#include <string>
+
+//============================================================================//
+// Reader handle for one .silo database (a per-cycle file or a cycle of the
+// time-series container).  The table of contents is read once on opening,
+// the time, cycle and mesh dimensions on first use, and the database is
+// closed when the reader goes out of scope.
+class SILO_Reader {
+    public:
+        SILO_Reader(char*,char*,char*,char*);
+        ~SILO_Reader(void);
+        int Kind(char*);
+        double Time(void);
+        int Cycle(void);
+        void GetMeshDims(int*);
+        void GetMeshCoords(float**);
+        void ReadScalar(char*,float*&,int*);
+        void ReadVector(char*,float**,int*);
+        void ReadVectorPlanes(char*,bool*,float**,int*);
+        
+    protected:
+        char *path;              // Directory holding the database
+        char *mesh_name;         // Name of the mesh in the database
+        char *stopmsg;           // Customizable error message
+        DBfile *dbfile;          // Open database (or the series container)
+        char dir[1001];          // Directory of this cycle in the database
+        map<string,int> toc;     // Kind of each object in the database
+        bool cyl_components;     // Vectors are stored as (z,r,phi)
+        bool meta_loaded;        // Time and cycle have been read
+        bool dims_loaded;        // Mesh dimensions have been read
+        double time;             // Time of this cycle
+        int cycle;               // Cycle number of this database
+        int mesh_dims[ndims];    // Dimensions of the stripped mesh
+        
+        void Select(void);
+        void LoadMeta(void);
+        DBquadvar *GetVar(char*,int,int*,bool*);
+        
+    private:
+        // Readers own their database handle and are not copied
+        SILO_Reader(const SILO_Reader&);
+        SILO_Reader &operator=(const SILO_Reader&);
+};
+
+//============================================================================//
+//============================================================================//
+
 void OpenFile_SILO(char*,char*,DBfile*&,char*);
+void CloseFile_SILO(DBfile*);
 void ReadScalar_SILO(char*,char*,char*,float*&,int*,char*);
 void ReadVector_SILO(char*,char*,char*,float**,int*,char*);
 double ReadTime_SILO(char*,char*,char*,char*);
+double *ReadTimes_SILO(char*,int,int,char*);
 int Get_Ncyc(char*,char*);
+int *Get_Cycles(char*,int&,char*);
 void Get_Mesh_Dims(char*,char*,char*,int*,char*);
 
 //============================================================================//
@@ -4,7 +4,7 @@
 Clayton Myers
 SILO_Write.cpp
 Created:  14 August 2009
-Modified: 17 September 2009
+Modified: 17 October 2026
 
 Support functions for writing data to new .silo databases.
 
@@ -13,38 +13,103 @@ Support functions for writing data to new .silo databases.
 //============================================================================//
 
 #include <HYM_SILO.hpp>
+#include <SILO_Write.hpp>
+#include <Thread_Functions.hpp>
+#include <Buffer_Pool.hpp>
+#include <Stage_Timers.hpp>
 
 //============================================================================//
 //============================================================================//
 void AddGhostZones_Coord(float*,float*&,int&);
+void MeshPhi_SILO(float*,float*&,int&);
+void PeriodicPhi_SILO(float*,int,float*);
+void BuildCylMesh_SILO(int*,float**,float**,int*);
+void TransformVectorCyl_SILO(float**,float**,int*);
 void AddGhostZones_Var(float*,float*&,int*);
-void Cyl_to_Cart(float**,float*,int*);
 void Set_Zeros(float*,int);
+void Ghost_Slab(int,int,void*);
+void Fused_Slab(int,int,void*);
+void Zero_Slab(int,int,void*);
+void Block_Slab(int,int,void*);
+void Rotate_Slab(int,int,void*);
+
+// Arguments for the slab-parallel kernels:
+struct GhostArgs {
+    float *var;          // Stripped variable
+    float *silovar;      // Ghosted variable
+    int Nq, Nr, Ns;      // Stripped dimensions
+};
+struct FusedArgs {
+    float *vec_q, *vec_r, *vec_s;  // Stripped cylindrical components
+    float *vec_x, *vec_y, *vec_z;  // Ghosted Cartesian components
+    float *cos_s, *sin_s;          // Rotation for each ghosted phi plane
+    int Nq, Nr, Ns;                // Stripped dimensions
+};
+struct BlockArgs {
+    float *src;          // Full ghosted array
+    float *dst;          // Block of the array
+    int *gdims;          // Dimensions of the full array
+    int *lo, *hi;        // Node range [lo,hi) of the block
+};
+struct RotateArgs {
+    float **vec;         // Block components (z,r,phi), replaced by (x,y,z)
+    float *cos_s, *sin_s;// Rotation for each ghosted phi plane
+    int k0;              // Ghosted phi plane of the first block plane
+    long Nplane;         // Nodes in each block plane
+};
 
 const float zero_threshold = 1.0E-7; // For the Set_Zero function
 
+// Output mode flags (set from the HYM_SILO command line):
+bool cyl_output = false;  // Collinear (z,r,phi) mesh and cylindrical vectors
+int silo_driver = DB_PDB; // SILO driver for new databases (DB_PDB or DB_HDF5)
+int Nblocks_q = 1;        // Number of output blocks in z
+int Nblocks_s = 1;        // Number of output blocks in phi
+
+inline float Zero_Threshold(float val) {
+    // Returns val, or zero if it is below zero_threshold in magnitude
+    return (val < zero_threshold && val > -zero_threshold) ? 0.0f : val;
+}
+
+//============================================================================//
+void SetDriver_SILO(int driver, char *compression) {
+    // Selects the driver for new .silo databases.  The compression string is
+    // passed to DBSetCompression (e.g. "METHOD=GZIP LEVEL=6", "METHOD=FPZIP"
+    // or "METHOD=SZIP") and only applies to HDF5 files, so it implies the HDF5
+    // driver.  The SILO HDF5 driver stores each compressed array as a single
+    // chunk.  A NULL compression string turns compression off.
+    if(compression != NULL)
+        driver = DB_HDF5;
+    silo_driver = driver;
+    DBSetCompression(compression);
+}
+
 //============================================================================//
 void WriteMesh_SILO(DBfile *dbfile, char *mesh_name, int *dims, 
                     float **mesh_coords, int cycle, double time) {
+    // Builds and writes the Cartesian quad mesh (see BuildMesh_SILO and 
+    // PutMesh_SILO to build the mesh once and reuse it for many cycles)
+    float *coords[ndims];
+    int silodims[ndims];
+    BuildMesh_SILO(dims,mesh_coords,coords,silodims);
+    PutMesh_SILO(dbfile,mesh_name,coords,silodims,cycle,time);
+    for(int m=0; m<ndims; m++) { delete [] coords[m]; }
+}
+
+//============================================================================//
+void BuildMesh_SILO(int *dims, float **mesh_coords, float **coords, 
+                    int *silodims) {
+    // Computes the ghosted Cartesian coordinates (xg,yg,zg) of the HYM mesh
+    if(cyl_output) {
+        BuildCylMesh_SILO(dims,mesh_coords,coords,silodims);
+        return;
+    }
     int i, j, k, n, Ntot;
     int Nq = dims[0], Nr = dims[1], Ns = dims[2];
     float *q = mesh_coords[0], *r = mesh_coords[1], *s = mesh_coords[2];
     float *s_ghost = NULL;
     
-
-    //if halfcyl, just extend array. else ie. periodic, add ghost zones/
-    if(half_cyl){
-         Ns+=1;
-         s_ghost=new float[Ns];
-         //copy array across into new slightly alrger array
-         for(k=0;k<Ns-1;k++){
-                    s_ghost[k]=s[k];
-         }
-         //add final phi=pi point
-         s_ghost[Ns-1]=s_ghost[Ns-2]+s_ghost[1];
-    }else{
-         AddGhostZones_Coord(s,s_ghost,Ns);               
-    }
+    MeshPhi_SILO(s,s_ghost,Ns);
     Ntot = Nq*Nr*Ns;
     
     float *xg=NULL, *yg=NULL, *zg=NULL;
@@ -54,10 +119,11 @@ void WriteMesh_SILO(DBfile *dbfile, char *mesh_name, int *dims,
     
     n = 0;
     for(k=0; k<Ns; k++) { 
+        double cos_k = cos(s_ghost[k]), sin_k = sin(s_ghost[k]);
         for(j=0; j<Nr; j++) {
             for(i=0; i<Nq; i++) {
-                xg[n] = r[j]*cos(s_ghost[k]);
-                yg[n] = r[j]*sin(s_ghost[k]);
+                xg[n] = r[j]*cos_k;
+                yg[n] = r[j]*sin_k;
                 zg[n] = q[i];
                 n++;
             } 
@@ -66,83 +132,484 @@ void WriteMesh_SILO(DBfile *dbfile, char *mesh_name, int *dims,
     
     delete [] s_ghost;
     
-    // Create the arrays to write to the .silo database:
-    int silodims[ndims] = {Nq,Nr,Ns};
-    float *coords[ndims] = {(float*)xg, (float*)yg, (float*)zg};
+    coords[0] = xg;
+    coords[1] = yg;
+    coords[2] = zg;
+    silodims[0] = Nq;
+    silodims[1] = Nr;
+    silodims[2] = Ns;
+}
+
+//============================================================================//
+void MeshPhi_SILO(float *s, float *&s_ghost, int &Ns) {
+    // Phi planes of the Cartesian mesh (Ns is updated to their number).  The
+    // mesh has the phi ghost planes of the variables in both geometries.  In
+    // a half cylinder the planes are continued by one period (pi), so that 
+    // the last plane before the upper ghost plane is the phi = pi point.
+    if(half_cyl){
+         s_ghost = new float[Ns+2*Nghost+1];
+         PeriodicPhi_SILO(s,Ns,s_ghost);
+         Ns += 2*Nghost + 1;
+    }else{
+         AddGhostZones_Coord(s,s_ghost,Ns);               
+    }
+}
+
+//============================================================================//
+void PeriodicPhi_SILO(float *s, int Ns, float *s_ghost) {
+    // Angles of the ghosted phi planes (see AddGhostZones_Var), continued by
+    // one period across the seam so that they increase monotonically
+    float period = (Ns > 1) ? Ns*(s[1]-s[0]) : 2.0*pi;
+    for(int k=0; k<Ns+2*Nghost+1; k++) {
+        int kk = k - Nghost;
+        int shift = (kk < 0) ? -1 : ((kk >= Ns) ? 1 : 0);
+        s_ghost[k] = s[kk - shift*Ns] + shift*period;
+    }
+}
+
+//============================================================================//
+void MeshDims_SILO(int *dims, int *silodims) {
+    // Dimensions of the mesh of BuildMesh_SILO (without building it), which
+    // are those of the ghosted variables
+    silodims[0] = dims[0];
+    silodims[1] = dims[1];
+    silodims[2] = dims[2] + 2*Nghost + 1;
+}
+
+//============================================================================//
+void BuildMeshRange_SILO(int *dims, float **mesh_coords, int *lo, int *hi,
+                         float **bcoords, int *bdims) {
+    // Computes the node range [lo,hi) of the mesh of BuildMesh_SILO straight
+    // from the coordinate vectors, without the full mesh (low-memory mode)
+    for(int m=0; m<ndims; m++)
+        bdims[m] = hi[m] - lo[m];
+    if(cyl_output) {
+        float *coords[ndims];
+        int silodims[ndims];
+        BuildCylMesh_SILO(dims,mesh_coords,coords,silodims);
+        BuildMeshBlock_SILO(coords,silodims,lo,hi,bcoords,bdims);
+        for(int m=0; m<ndims; m++) { delete [] coords[m]; }
+        return;
+    }
+    int Ns = dims[2];
+    float *q = mesh_coords[0], *r = mesh_coords[1], *s_ghost = NULL;
+    MeshPhi_SILO(mesh_coords[2],s_ghost,Ns);
+    
+    long Nblock = (long)bdims[0]*bdims[1]*bdims[2], n = 0;
+    for(int m=0; m<ndims; m++) { bcoords[m] = new float[Nblock]; }
+    for(int k=lo[2]; k<hi[2]; k++) {
+        double cos_k = cos(s_ghost[k]), sin_k = sin(s_ghost[k]);
+        for(int j=lo[1]; j<hi[1]; j++) {
+            for(int i=lo[0]; i<hi[0]; i++) {
+                bcoords[0][n] = r[j]*cos_k;
+                bcoords[1][n] = r[j]*sin_k;
+                bcoords[2][n] = q[i];
+                n++;
+            }
+        }
+    }
+    delete [] s_ghost;
+}
+
+//============================================================================//
+void BuildCylMesh_SILO(int *dims, float **mesh_coords, float **coords, 
+                       int *silodims) {
+    // Builds the collinear (z,r,phi) coordinate vectors of the HYM mesh.  The
+    // phi vector has the same ghost planes as the variables, shifted by one
+    // period so that it stays monotonic across the periodic seam.
+    int Nq = dims[0], Nr = dims[1], Ns = dims[2];
+    int Ns_g = Ns + 2*Nghost + 1;
+    
+    coords[0] = new float[Nq];
+    coords[1] = new float[Nr];
+    coords[2] = new float[Ns_g];
+    memcpy(coords[0],mesh_coords[0],Nq*sizeof(float));
+    memcpy(coords[1],mesh_coords[1],Nr*sizeof(float));
+    PeriodicPhi_SILO(mesh_coords[2],Ns,coords[2]);
     
+    silodims[0] = Nq;
+    silodims[1] = Nr;
+    silodims[2] = Ns_g;
+}
+
+//============================================================================//
+void PutMesh_SILO(DBfile *dbfile, char *mesh_name, float **coords, 
+                  int *silodims, int cycle, double time) {
+    PutMeshBlock_SILO(dbfile,mesh_name,coords,silodims,cycle,time,true,true);
+}
+
+//============================================================================//
+void PutMeshBlock_SILO(DBfile *dbfile, char *mesh_name, float **coords, 
+                       int *silodims, int cycle, double time, bool lo_ghost,
+                       bool hi_ghost) {
+    // Writes a mesh (or one block of it) whose first and/or last phi planes
+    // are marked as ghost planes
     // Create an option list to save cycle and time values:
-    DBoptlist *optlist = DBMakeOptlist(4);
-    if(!half_cyl){
-          int offset_low[ndims] = {0,0,Nghost};
-          int offset_high[ndims] = {0,0,Nghost};
+    DBoptlist *optlist = DBMakeOptlist(8);
+    int offset_low[ndims] = {0,0,lo_ghost ? Nghost : 0};
+    int offset_high[ndims] = {0,0,hi_ghost ? Nghost : 0};
+    if(lo_ghost || hi_ghost){
           DBAddOption(optlist, DBOPT_LO_OFFSET, offset_low);
           DBAddOption(optlist, DBOPT_HI_OFFSET, offset_high);                  
     }
     DBAddOption(optlist, DBOPT_DTIME, &time);
     DBAddOption(optlist, DBOPT_CYCLE, &cycle);
 
-    // DBAddOption(optlist, DBOPT_COORDSYS, DB_CYLINDRICAL);
 
     // Write the mesh to the .silo file:
-    DBPutQuadmesh(dbfile, mesh_name, NULL, coords, silodims, ndims,
-                  DB_FLOAT, DB_NONCOLLINEAR, optlist);
+    StageTimer timer(stage_put,0);
+    if(cyl_output) {
+        timer.AddBytes((long)(silodims[0]+silodims[1]+silodims[2])*
+                       sizeof(float));
+        int coordsys = DB_CYLINDRICAL;
+        DBAddOption(optlist, DBOPT_COORDSYS, &coordsys);
+        DBAddOption(optlist, DBOPT_XLABEL, (void*)"z");
+        DBAddOption(optlist, DBOPT_YLABEL, (void*)"r");
+        DBAddOption(optlist, DBOPT_ZLABEL, (void*)"phi");
+        DBPutQuadmesh(dbfile, mesh_name, NULL, coords, silodims, ndims,
+                      DB_FLOAT, DB_COLLINEAR, optlist);
+    }
+    else {
+        timer.AddBytes((long)ndims*silodims[0]*silodims[1]*silodims[2]*
+                       sizeof(float));
+        DBPutQuadmesh(dbfile, mesh_name, NULL, coords, silodims, ndims,
+                      DB_FLOAT, DB_NONCOLLINEAR, optlist);
+    }
                   
     DBFreeOptlist(optlist);
+}
+
+//============================================================================//
+void PutMeshRef_SILO(DBfile *dbfile, char *mesh_name, char *mesh_file, 
+                     int cycle, double time) {
+    // Writes a single-block multimesh that refers to the mesh stored in the 
+    // shared mesh file, along with the cycle and time of this database
+    char block_name[1001];
+    sprintf(block_name,"%s:/%s",mesh_file,mesh_name);
+    char *block_names[1] = {block_name};
+    PutMultimesh_SILO(dbfile,mesh_name,1,block_names,cycle,time);
+}
+
+//============================================================================//
+void PutMultimesh_SILO(DBfile *dbfile, char *mesh_name, int Nblocks, 
+                       char **block_names, int cycle, double time) {
+    // Writes a multimesh of the quad mesh blocks in block_names, along with 
+    // the cycle and time of this database
+    int *block_types = new int[Nblocks];
+    for(int b=0; b<Nblocks; b++)
+        block_types[b] = cyl_output ? DB_QUAD_RECT : DB_QUAD_CURV;
     
-    delete [] xg;
-    delete [] yg;
-    delete [] zg;
-    
+    DBoptlist *optlist = DBMakeOptlist(2);
+    DBAddOption(optlist, DBOPT_DTIME, &time);
+    DBAddOption(optlist, DBOPT_CYCLE, &cycle);
+    StageTimer timer(stage_put,0);
+    DBPutMultimesh(dbfile, mesh_name, Nblocks, block_names, block_types, 
+                   optlist);
+    DBFreeOptlist(optlist);
+    delete [] block_types;
+    PutTime_SILO(dbfile, cycle, time);
+}
+
+//============================================================================//
+void PutTime_SILO(DBfile *dbfile, int cycle, double time) {
+    // Plain time and cycle entries (read by VisIt and by the SILO readers 
+    // without loading the mesh)
+    int one = 1;
+    DBWrite(dbfile, "dtime", &time, &one, 1, DB_DOUBLE);
+    DBWrite(dbfile, "cycle", &cycle, &one, 1, DB_INT);
+}
+
+//============================================================================//
+void PutCoordSys_SILO(DBfile *dbfile) {
+    // Marks a database whose vectors are stored as (z,r,phi) components so 
+    // that ReadVector_SILO skips the Cartesian-to-cylindrical conversion
+    int one = 1, flag = 1;
+    DBWrite(dbfile, "cyl_components", &flag, &one, 1, DB_INT);
+}
+
+//============================================================================//
+void PutVarRef_SILO(DBfile *dbfile, char *vname, char *block_name) {
+    // Writes a single-block multivar for a variable stored at block_name
+    char *block_names[1] = {block_name};
+    PutMultivar_SILO(dbfile,vname,1,block_names);
+}
+
+//============================================================================//
+void PutMultivar_SILO(DBfile *dbfile, char *vname, int Nblocks, 
+                      char **block_names) {
+    // Writes a multivar of the quad variable blocks in block_names
+    int *block_types = new int[Nblocks];
+    for(int b=0; b<Nblocks; b++)
+        block_types[b] = DB_QUADVAR;
+    StageTimer timer(stage_put,0);
+    DBPutMultivar(dbfile, vname, Nblocks, block_names, block_types, NULL);
+    delete [] block_types;
+}
+
+//============================================================================//
+void PutBlockIndex_SILO(DBfile *dbfile, int *gdims) {
+    // Writes the node range of each block ("block_index": lo[3] and hi[3] per
+    // block, in the order of the multimesh) so that the SILO readers can 
+    // reassemble the full arrays
+    int Nblocks = Nblocks_q*Nblocks_s;
+    int length = 2*ndims*Nblocks;
+    int *block_index = new int[length];
+    for(int b=0; b<Nblocks; b++)
+        BlockIndex_SILO(gdims,b,block_index+2*ndims*b,
+                        block_index+2*ndims*b+ndims);
+    DBWrite(dbfile, "block_index", block_index, &length, 1, DB_INT);
+    delete [] block_index;
+}
+
+//============================================================================//
+//============================================================================//
+void BlockIndex_SILO(int *gdims, int b, int *lo, int *hi) {
+    // Gets the node range [lo,hi) of block b (numbered fastest in z) of an 
+    // array with the dimensions gdims.  Neighbouring blocks share their 
+    // boundary node plane so that no zones are lost between blocks.
+    int nb[ndims] = {Nblocks_q,1,Nblocks_s};
+    int ib[ndims] = {b%Nblocks_q,0,b/Nblocks_q};
+    for(int m=0; m<ndims; m++) {
+        lo[m] = (int)(((long)(gdims[m]-1)*ib[m])/nb[m]);
+        hi[m] = (int)(((long)(gdims[m]-1)*(ib[m]+1))/nb[m]) + 1;
+    }
+}
+
+//============================================================================//
+void ExtractBlock_SILO(float *src, float *&dst, int *gdims, int *lo, int *hi) {
+    // Copies the node range [lo,hi) out of a full ghosted array (the phi 
+    // planes are split over the threads).  The block comes from the session
+    // pool and is returned with BufferPool::Put.
+    dst = BufferPool::Floats((long)(hi[0]-lo[0])*(hi[1]-lo[1])*(hi[2]-lo[2]));
+    BlockArgs args = {src,dst,gdims,lo,hi};
+    Parallel_For(hi[2]-lo[2],Block_Slab,&args);
+}
+
+//============================================================================//
+void BuildMeshBlock_SILO(float **coords, int *gdims, int *lo, int *hi, 
+                         float **bcoords, int *bdims) {
+    // Cuts one block out of a mesh from BuildMesh_SILO
+    for(int m=0; m<ndims; m++)
+        bdims[m] = hi[m] - lo[m];
+    if(cyl_output) {
+        // Collinear mesh: one coordinate vector per dimension
+        for(int m=0; m<ndims; m++) {
+            bcoords[m] = new float[bdims[m]];
+            memcpy(bcoords[m],coords[m]+lo[m],bdims[m]*sizeof(float));
+        }
+    }
+    else {
+        for(int m=0; m<ndims; m++)
+            ExtractBlock_SILO(coords[m],bcoords[m],gdims,lo,hi);
+    }
+}
+
+//============================================================================//
+void PutQuadvar_SILO(DBfile *dbfile, char *vname, char *mesh_name, int nvals,
+                     char **compnames, float **silovals, int *silodims) {
+    // Writes a (block of a) scalar or vector with the dimensions silodims
+    StageTimer timer(stage_put,(long)nvals*silodims[0]*silodims[1]*
+                               silodims[2]*sizeof(float));
+    DBPutQuadvar(dbfile, vname, mesh_name, nvals, compnames, silovals, 
+                 silodims, ndims, NULL, 0, DB_FLOAT, DB_NODECENT, NULL);
 }
 
 //============================================================================//
 void WriteScalar_SILO(DBfile *dbfile, char *vname, char *mesh_name, float *var, 
                       int *dims) {
     // This function writes the data in var to the .silo database file
-    int silodims[ndims] = {dims[0],dims[1],dims[2]+2*Nghost+1};
     float *silovar;
-    if(halfcyl){
-          AddFinalZone_Var(var,silovar,dims);              
-    }else{
-          // Add the SILO ghost zones to the data:
-          AddGhostZones_Var(var,silovar,dims);
-    }
+    TransformScalar_SILO(var,silovar,dims);
+    PutScalar_SILO(dbfile,vname,mesh_name,silovar,dims);
+    BufferPool::Put(silovar);
+}
+
+//============================================================================//
+void TransformScalar_SILO(float *var, float *&silovar, int *dims) {
+    // Builds the SILO-ready copy of a stripped scalar (ghost zones and zeros)
+    int silodims[ndims] = {dims[0],dims[1],dims[2]+2*Nghost+1};
+    // Add the SILO ghost zones to the data:
+    AddGhostZones_Var(var,silovar,dims);
     // Remove nonzero elements below a threshold (e.g. 1e-10):
     Set_Zeros(silovar,silodims[0]*silodims[1]*silodims[2]);
+}
+
+//============================================================================//
+void PutScalar_SILO(DBfile *dbfile, char *vname, char *mesh_name, 
+                    float *silovar, int *dims) {
     // Write the data to the .silo file:
+    int silodims[ndims] = {dims[0],dims[1],dims[2]+2*Nghost+1};
+    StageTimer timer(stage_put,(long)silodims[0]*silodims[1]*silodims[2]*
+                               sizeof(float));
     DBPutQuadvar1(dbfile, vname, mesh_name, silovar, silodims, ndims, NULL, 0,
                   DB_FLOAT, DB_NODECENT, NULL);
-    delete [] silovar;
 }
 
 //============================================================================//
 void WriteVector_SILO(DBfile *dbfile, char *vname, char *mesh_name, 
                       char **varnames, float **vec, float *s, int* dims) {
     // This function writes the data in vec to the .silo database file
-    int Ntot;
-    int silodims[ndims] = {dims[0],dims[1],dims[2]+2*Nghost+1};
     float *silovec[ndims];
-    if(halfcyl){
-        AddFinalZone_Var(vec[0],silovec[0],dims);
-        AddFinalZone_Var(vec[1],silovec[1],dims);  
-        AddFinalZone_Var(vec[2],silovec[2],dims);  
-    }else
-        // Add the SILO ghost zones to the data:
-        AddGhostZones_Var(vec[0],silovec[0],dims);
-        AddGhostZones_Var(vec[1],silovec[1],dims);
-        AddGhostZones_Var(vec[2],silovec[2],dims);
+    TransformVector_SILO(vec,silovec,s,dims);
+    PutVector_SILO(dbfile,vname,mesh_name,varnames,silovec,dims);
+    for(int m=0; m<ndims; m++) { BufferPool::Put(silovec[m]); }
+}
+
+//============================================================================//
+void TransformVector_SILO(float **vec, float **silovec, float *s, int *dims) {
+    // Builds the SILO-ready Cartesian copy of a stripped cylindrical vector in
+    // a single pass: each ghosted phi plane is read from its periodic source 
+    // plane, rotated with the tabulated cos/sin of its angle and thresholded.
+    // (The ghost planes and zeros of this pass are timed as cyl_to_cart.)
+    if(cyl_output) {
+        TransformVectorCyl_SILO(vec,silovec,dims);
+        return;
     }
-    // Convert to Cartesian vector components:
-    Cyl_to_Cart(silovec,s,dims);
-    // Remove nonzero elements below a threshold (e.g. 1e-10):
-    Ntot = silodims[0]*silodims[1]*silodims[2];
-    Set_Zeros(silovec[0],Ntot);
-    Set_Zeros(silovec[1],Ntot);
-    Set_Zeros(silovec[2],Ntot);
+    int k, Ns = dims[2];
+    int Nq = dims[0], Nr = dims[1], Ns_g = dims[2] + 2*Nghost + 1;
+    long Ntot = (long)Nq*Nr*Ns_g;
+    StageTimer timer(stage_cyl_to_cart,ndims*Ntot*(long)sizeof(float));
+    float *s_ghost = NULL;
+    
+    // Tabulate the rotation for each ghosted phi plane (at the mesh angles):
+    MeshPhi_SILO(s,s_ghost,Ns);
+    float *cos_s = new float[Ns_g];
+    float *sin_s = new float[Ns_g];
+    for(k=0; k<Ns_g; k++) {
+        cos_s[k] = cos(s_ghost[k]);
+        sin_s[k] = sin(s_ghost[k]);
+    }
+    delete [] s_ghost;
+    
+    // Sorted into the (x,y,z) arrangement:
+    for(int m=0; m<ndims; m++) { silovec[m] = BufferPool::Floats(Ntot); }
+    FusedArgs args = {vec[0],vec[1],vec[2],silovec[0],silovec[1],silovec[2],
+                      cos_s,sin_s,Nq,Nr,dims[2]};
+    Parallel_For(Ns_g,Fused_Slab,&args);
+    
+    //set exclude origin in HYM_SILO.hpp
+    if(exclude_origin) {
+        // Interpolate on axis at r=0 from the unthresholded j=1 values.  The
+        // phi planes are the outer loop so that the j=1 rows are read and the
+        // axis rows written contiguously (instead of striding by Nq*Nr).
+        long Nplane = (long)Nq*Nr;
+        long n, ns;
+        int nsum = Ns_g - 2*Nghost - 1;
+        float *vec_x_sum = new float[Nq];
+        float *vec_y_sum = new float[Nq];
+        for(int i=0; i<Nq; i++) {
+            vec_x_sum[i] = 0.;
+            vec_y_sum[i] = 0.;
+        }
+        for(k=Nghost; k<(Ns_g-Nghost-1); k++) {
+            ns = (k-Nghost)*Nplane + fn(0,1,0,Nq,Nr);
+            for(int i=0; i<Nq; i++) {
+                vec_x_sum[i] += vec[1][ns+i]*cos_s[k] - vec[2][ns+i]*sin_s[k];
+                vec_y_sum[i] += vec[1][ns+i]*sin_s[k] + vec[2][ns+i]*cos_s[k];
+            }
+        }
+        for(k=0; k<Ns_g; k++) {
+            n = fn(0,0,k,Nq,Nr);
+            for(int i=0; i<Nq; i++) {
+                silovec[0][n+i] = Zero_Threshold(vec_x_sum[i]/nsum);
+                silovec[1][n+i] = Zero_Threshold(vec_y_sum[i]/nsum);
+            }
+        }
+        delete [] vec_x_sum;
+        delete [] vec_y_sum;
+    }
+    
+    delete [] cos_s;
+    delete [] sin_s;
+}
+
+//============================================================================//
+void TransformVectorCyl_SILO(float **vec, float **silovec, int *dims) {
+    // Builds the SILO-ready copy of a stripped vector in its native (z,r,phi)
+    // components (ghost zones and zeros only).  The on-axis average of 
+    // exclude_origin is not applied since the r and phi components are not
+    // single valued at r = 0.
+    int silodims[ndims] = {dims[0],dims[1],dims[2]+2*Nghost+1};
+    for(int m=0; m<ndims; m++) {
+        AddGhostZones_Var(vec[m],silovec[m],dims);
+        Set_Zeros(silovec[m],silodims[0]*silodims[1]*silodims[2]);
+    }
+}
+
+//============================================================================//
+void TransformBlock_SILO(float **vals, int nvals, float *s, int *dims, 
+                         int *lo, int *hi, float **axis) {
+    // Converts one block [lo,hi) of a variable, read in the ghosted layout in
+    // its native components (see HYMDataObj::ReadBlock_Binary), to the 
+    // SILO-ready data in place: the vector components are rotated to (x,y,z)
+    // with the angle of each ghosted phi plane (unless cyl_output) and all 
+    // components are thresholded.  For exclude_origin, axis holds the r and
+    // phi components on the j=1 row of the block's z range for every 
+    // stripped phi plane (axis[1] and axis[2], z fastest), and the r=0 rows 
+    // of the block get their average as in TransformVector_SILO.
+    int Nq = hi[0]-lo[0], Nr = hi[1]-lo[1], Nk = hi[2]-lo[2];
+    int Ns = dims[2], Ns_g = dims[2] + 2*Nghost + 1;
+    long Nplane = (long)Nq*Nr;
+    if(nvals != ndims || cyl_output) {
+        for(int m=0; m<nvals; m++)
+            Set_Zeros(vals[m],(int)(Nplane*Nk));
+        return;
+    }
+    StageTimer timer(stage_cyl_to_cart,ndims*Nplane*Nk*(long)sizeof(float));
+    
+    // Tabulate the rotation for each ghosted phi plane (at the mesh angles):
+    float *s_ghost = NULL;
+    int Ns_c = Ns;
+    MeshPhi_SILO(s,s_ghost,Ns_c);
+    float *cos_s = new float[Ns_g];
+    float *sin_s = new float[Ns_g];
+    for(int k=0; k<Ns_g; k++) {
+        cos_s[k] = cos(s_ghost[k]);
+        sin_s[k] = sin(s_ghost[k]);
+    }
+    delete [] s_ghost;
+    
+    RotateArgs args = {vals,cos_s,sin_s,lo[2],Nplane};
+    Parallel_For(Nk,Rotate_Slab,&args);
+    
+    if(exclude_origin && axis != NULL && lo[1] == 0) {
+        float *vec_x_sum = new float[Nq];
+        float *vec_y_sum = new float[Nq];
+        for(int i=0; i<Nq; i++) {
+            vec_x_sum[i] = 0.;
+            vec_y_sum[i] = 0.;
+        }
+        for(int k=Nghost; k<(Ns_g-Nghost-1); k++) {
+            long ns = (long)(k-Nghost)*Nq;
+            for(int i=0; i<Nq; i++) {
+                vec_x_sum[i] += axis[1][ns+i]*cos_s[k] - axis[2][ns+i]*sin_s[k];
+                vec_y_sum[i] += axis[1][ns+i]*sin_s[k] + axis[2][ns+i]*cos_s[k];
+            }
+        }
+        for(int k=0; k<Nk; k++) {
+            long n = k*Nplane;
+            for(int i=0; i<Nq; i++) {
+                vals[0][n+i] = Zero_Threshold(vec_x_sum[i]/Ns);
+                vals[1][n+i] = Zero_Threshold(vec_y_sum[i]/Ns);
+            }
+        }
+        delete [] vec_x_sum;
+        delete [] vec_y_sum;
+    }
+    
+    delete [] cos_s;
+    delete [] sin_s;
+}
+
+//============================================================================//
+void PutVector_SILO(DBfile *dbfile, char *vname, char *mesh_name, 
+                    char **varnames, float **silovec, int *dims) {
     // Write the vector to the .silo file:
+    int silodims[ndims] = {dims[0],dims[1],dims[2]+2*Nghost+1};
+    StageTimer timer(stage_put,(long)ndims*silodims[0]*silodims[1]*
+                               silodims[2]*sizeof(float));
     DBPutQuadvar(dbfile, vname, mesh_name, ndims, varnames, silovec, silodims,
                  ndims, NULL, 0, DB_FLOAT, DB_NODECENT, NULL);    
-    for(int m=0; m<ndims; m++) { delete [] silovec[m]; }
 }
 
 //============================================================================//
@@ -165,118 +632,107 @@ void AddGhostZones_Coord(float *s, float *&s_ghost, int &Ns) {
 
 //============================================================================//
 void AddGhostZones_Var(float *var, float *&silovar, int *dims) {
-    // Add the SILO ghost zones (in phi) to the variable
-    int nshift, Ntot, n;
+    // Add the SILO ghost zones (in phi) to the variable.  Each ghosted plane 
+    // kg is a copy of the periodic source plane (kg-Nghost) mod Ns, and the
+    // planes are split over the threads.
     int Nq = dims[0], Nr = dims[1], Ns = dims[2] + 2*Nghost + 1;
-    
-    Ntot = Nq*Nr*Ns;
-    silovar = new float[Ntot];
-    nshift = Ntot - (2*Nghost+1)*Nq*Nr;
-    n = Nghost*Nq*Nr;
-    for(int k=Nghost; k<(Ns-Nghost-1); k++) {
-        for(int j=0; j<Nr; j++) {
-            for(int i=0; i<Nq; i++) {
-                silovar[n] = var[n-Nghost*Nq*Nr]; 
-                // Continuous periodicity/ghost zones at top of mesh:
-                if(k < (2*Nghost+1))
-                    silovar[n+nshift] = silovar[n];
-                // Ghost zones at the bottom of the mesh:
-                if(k >= (Ns-(2*Nghost+1)))
-                    silovar[n-nshift] = silovar[n];
-                n++;                
-            }
-        }
+    StageTimer timer(stage_ghost,(long)Nq*Nr*Ns*sizeof(float));
+    silovar = BufferPool::Floats((long)Nq*Nr*Ns);
+    GhostArgs args = {var,silovar,Nq,Nr,dims[2]};
+    Parallel_For(Ns,Ghost_Slab,&args);
+}
+
+//============================================================================//
+void Ghost_Slab(int k1, int k2, void *arg) {
+    // Fills the ghosted phi planes [k1,k2) from the stripped variable
+    GhostArgs *args = (GhostArgs*)arg;
+    long Nplane = (long)args->Nq*args->Nr;
+    int ks;
+    for(int k=k1; k<k2; k++) {
+        ks = (k - Nghost + args->Ns) % args->Ns;
+        memcpy(args->silovar+k*Nplane,args->var+ks*Nplane,
+               Nplane*sizeof(float));
     }
 }
 
 //============================================================================//
-void AddFinalZone_Var(float *var, float *&silovar, int *dims) {
-    // Add the SILO ghost zones (in phi) to the variable
-    int nshift, Ntot, n;
-    int Nq = dims[0], Nr = dims[1], Ns = dims[2] + 2*Nghost + 1;
-    
-    Ntot = Nq*Nr*Ns;
-    silovar = new float[Ntot];
-    nshift = Ntot - (2*Nghost+1)*Nq*Nr;
-    n = Nghost*Nq*Nr;
-    for(int k=Nghost; k<(Ns-Nghost-1); k++) {
-        for(int j=0; j<Nr; j++) {
-            for(int i=0; i<Nq; i++) {
-                silovar[n] = var[n-Nghost*Nq*Nr]; 
-                // Continuous periodicity/ghost zones at top of mesh:
-                if(k < (2*Nghost+1))
-                    silovar[n+nshift] = silovar[n];
-                // Ghost zones at the bottom of the mesh:
-                if(k >= (Ns-(2*Nghost+1)))
-                    silovar[n-nshift] = silovar[n];
-                n++;                
-            }
+void Fused_Slab(int k1, int k2, void *arg) {
+    // Fills the ghosted Cartesian phi planes [k1,k2) directly from the 
+    // stripped cylindrical components
+    FusedArgs *args = (FusedArgs*)arg;
+    long Nplane = (long)args->Nq*args->Nr;
+    float cos_k, sin_k, vr, vs;
+    for(int k=k1; k<k2; k++) {
+        long ks = (k - Nghost + args->Ns) % args->Ns;
+        const float *q_in = args->vec_q + ks*Nplane;
+        const float *r_in = args->vec_r + ks*Nplane;
+        const float *s_in = args->vec_s + ks*Nplane;
+        float *x_out = args->vec_x + k*Nplane;
+        float *y_out = args->vec_y + k*Nplane;
+        float *z_out = args->vec_z + k*Nplane;
+        cos_k = args->cos_s[k];
+        sin_k = args->sin_s[k];
+        for(long n=0; n<Nplane; n++) {
+            vr = r_in[n];
+            vs = s_in[n];
+            x_out[n] = Zero_Threshold(vr*cos_k - vs*sin_k);
+            y_out[n] = Zero_Threshold(vr*sin_k + vs*cos_k);
+            z_out[n] = Zero_Threshold(q_in[n]);
         }
     }
 }
 
 //============================================================================//
-void Cyl_to_Cart(float **vec, float *s, int *dims) {
-    // Add functionality comment here
-    int i, j, k, n, Ntot;
-    int Nq = dims[0], Nr = dims[1], Ns = dims[2];
-    float *vec_q = vec[0], *vec_r = vec[1], *vec_s = vec[2];
-    float *vec_x=NULL, *vec_y=NULL, *s_ghost=NULL;
-    
-    AddGhostZones_Coord(s,s_ghost,Ns);
-    Ntot = Nq*Nr*Ns;
-    vec_x = new float[Ntot];
-    vec_y = new float[Ntot];
-    
-    // Convert (r,phi) components to (x,y) components
-    n = 0;
-    for(k=0; k<Ns; k++) {
-        for(j=0; j<Nr; j++) {
-            for(i=0; i<Nq; i++) {
-                vec_x[n] = vec_r[n]*cos(s_ghost[k]) - vec_s[n]*sin(s_ghost[k]);
-                vec_y[n] = vec_r[n]*sin(s_ghost[k]) + vec_s[n]*cos(s_ghost[k]);
-                n++;
-            }
+void Rotate_Slab(int k1, int k2, void *arg) {
+    // Rotates the block phi planes [k1,k2) from (z,r,phi) to thresholded 
+    // (x,y,z) components in place
+    RotateArgs *args = (RotateArgs*)arg;
+    float cos_k, sin_k, vq, vr, vs;
+    for(int k=k1; k<k2; k++) {
+        float *v0 = args->vec[0] + k*args->Nplane;
+        float *v1 = args->vec[1] + k*args->Nplane;
+        float *v2 = args->vec[2] + k*args->Nplane;
+        cos_k = args->cos_s[args->k0+k];
+        sin_k = args->sin_s[args->k0+k];
+        for(long n=0; n<args->Nplane; n++) {
+            vq = v0[n];
+            vr = v1[n];
+            vs = v2[n];
+            v0[n] = Zero_Threshold(vr*cos_k - vs*sin_k);
+            v1[n] = Zero_Threshold(vr*sin_k + vs*cos_k);
+            v2[n] = Zero_Threshold(vq);
         }
     }
-    //set exclude origin in HYM_SILO.hpp
-    if(exclude_origin){
-        // Interpolate on axis at r=0
-        for(i=0; i<Nq; i++) {
-            int nsum=0;
-            float vec_x_sum=0., vec_y_sum=0.;
-            for(k=Nghost; k<(Ns-Nghost-1); k++) {
-                n = fn(i,1,k,Nq,Nr);
-                vec_x_sum += vec_x[n];
-                vec_y_sum += vec_y[n];
-                nsum++;
-            }
-            for(k=0; k<Ns; k++) {
-                n = fn(i,0,k,Nq,Nr); 
-                vec_x[n] = vec_x_sum/nsum;
-                vec_y[n] = vec_y_sum/nsum;
-            }
+}
+
+//============================================================================//
+void Block_Slab(int k1, int k2, void *arg) {
+    // Copies the block phi planes [k1,k2) (relative to lo[2])
+    BlockArgs *args = (BlockArgs*)arg;
+    int *lo = args->lo, *hi = args->hi;
+    int Nq = hi[0]-lo[0], Nr = hi[1]-lo[1];
+    long n = (long)k1*Nq*Nr;
+    for(int k=lo[2]+k1; k<lo[2]+k2; k++) {
+        for(int j=lo[1]; j<hi[1]; j++) {
+            long ns = fn(lo[0],j,k,args->gdims[0],args->gdims[1]);
+            memcpy(args->dst+n,args->src+ns,Nq*sizeof(float));
+            n += Nq;
         }
     }
-    
-    // Replace and sort the vector components into the (x,y,z) arrangement
-    delete [] vec_r; delete [] vec_s; delete [] s_ghost;
-    vec[0] = vec_x;
-    vec[1] = vec_y;
-    vec[2] = vec_q;
 }
 
 //============================================================================//
 void Set_Zeros(float *var, int Ntot) {
-    float dum;
-    for(int n=0; n<Ntot; n++) {
-        if(var[n] < 0)
-            dum = -var[n];
-        else
-            dum = var[n];
-        if(dum < zero_threshold)
-            var[n] = 0.0;
-    }
+    // Sets the elements below zero_threshold in magnitude to zero
+    StageTimer timer(stage_zeros,(long)Ntot*sizeof(float));
+    Parallel_For(Ntot,Zero_Slab,var);
+}
+
+//============================================================================//
+void Zero_Slab(int n1, int n2, void *arg) {
+    float *var = (float*)arg;
+    for(int n=n1; n<n2; n++)
+        var[n] = Zero_Threshold(var[n]);
 }
 
 //============================================================================//
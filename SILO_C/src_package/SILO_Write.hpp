@@ -4,7 +4,7 @@
 Clayton Myers
 SILO_Write.hpp
 Created:  17 September 2009
-Modified: 17 September 2009
+Modified: 17 October 2026
 
 Header file for SILO write functions.
 
@@ -12,9 +12,39 @@ Header file for SILO write functions.
 //============================================================================//
 //============================================================================//
 
+extern bool cyl_output;  // Collinear (z,r,phi) mesh and cylindrical vectors
+extern int silo_driver;  // SILO driver for new databases
+extern int Nblocks_q;    // Number of output blocks in z
+extern int Nblocks_s;    // Number of output blocks in phi
+
+void SetDriver_SILO(int,char*);
+
 void WriteMesh_SILO(DBfile*,char*,int*,float**,int,double);
+void BuildMesh_SILO(int*,float**,float**,int*);
+void MeshDims_SILO(int*,int*);
+void BuildMeshRange_SILO(int*,float**,int*,int*,float**,int*);
+void PutMesh_SILO(DBfile*,char*,float**,int*,int,double);
+void PutMeshBlock_SILO(DBfile*,char*,float**,int*,int,double,bool,bool);
+void PutMeshRef_SILO(DBfile*,char*,char*,int,double);
+void PutMultimesh_SILO(DBfile*,char*,int,char**,int,double);
+void PutTime_SILO(DBfile*,int,double);
+void PutCoordSys_SILO(DBfile*);
+void PutVarRef_SILO(DBfile*,char*,char*);
+void PutMultivar_SILO(DBfile*,char*,int,char**);
+void PutBlockIndex_SILO(DBfile*,int*);
 void WriteScalar_SILO(DBfile*,char*,char*,float*,int*);
 void WriteVector_SILO(DBfile*,char*,char*,char**,float**,float*,int*);
 
+void TransformScalar_SILO(float*,float*&,int*);
+void TransformVector_SILO(float**,float**,float*,int*);
+void TransformBlock_SILO(float**,int,float*,int*,int*,int*,float**);
+void PutScalar_SILO(DBfile*,char*,char*,float*,int*);
+void PutVector_SILO(DBfile*,char*,char*,char**,float**,int*);
+void PutQuadvar_SILO(DBfile*,char*,char*,int,char**,float**,int*);
+
+void BlockIndex_SILO(int*,int,int*,int*);
+void ExtractBlock_SILO(float*,float*&,int*,int*,int*);
+void BuildMeshBlock_SILO(float**,int*,int*,int*,float**,int*);
+
 //============================================================================//
 //============================================================================//
@@ -0,0 +1,244 @@
+//============================================================================//
+/*
+
+Clayton Myers
+Stage_Timers.cpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Per-stage timers of the conversion and analysis drivers.  A StageTimer is
+declared in the scope of a stage (a binary read, a transform kernel, a DBPut*
+call, ...) and adds its wall time, the bytes it moved and the call to the row
+of the cycle being worked on, so that a slow run can be told to be disk-,
+compute- or SILO-bound from the report alone.  The stages of concurrent
+threads overlap, so the stage times of a row can add up to more than its wall
+time.
+
+The report is written as <prefix>.json and <prefix>.csv.  The CSV file has one
+line for each cycle (0 for the session) and stage with the calls, seconds,
+bytes and MB/s, followed by the totals of each stage (cycle "total") and a
+"cycles" line with the number of cycles and the wall time of the session.
+
+*/
+//============================================================================//
+//============================================================================//
+
+#include <HYM_SILO.hpp>
+#include <Stage_Timers.hpp>
+
+#include <sys/time.h>
+
+const char *stage_names[Nstages] = {"index","read","strip","ghost",
+                                    "cyl_to_cart","zeros","put","close",
+                                    "analysis"};
+
+bool StageTimer::enabled = false;
+std::map<int,StageTimer::Row> StageTimer::rows;
+double StageTimer::session_start = 0.0;
+pthread_mutex_t StageTimer::lock = PTHREAD_MUTEX_INITIALIZER;
+
+pthread_key_t cycle_key;
+pthread_once_t cycle_once = PTHREAD_ONCE_INIT;
+
+inline double MB_Rate(long bytes, double seconds) {
+    // Throughput in MB/s (1 MB = 1.0E6 bytes, as in --bench)
+    return (seconds > 0.0) ? bytes/1.0E6/seconds : 0.0;
+}
+
+//============================================================================//
+//============================================================================//
+void Make_Cycle_Key(void) {
+    pthread_key_create(&cycle_key,NULL);
+}
+
+//============================================================================//
+StageTimer::StageTimer(int stage, long bytes) {
+    this->stage = stage;
+    this->bytes = bytes;
+    if(!enabled)
+        return;
+    this->cycle = StageTimer::Get_Cycle();
+    this->start = StageTimer::Now();
+}
+
+//============================================================================//
+StageTimer::~StageTimer(void) {
+    if(!enabled)
+        return;
+    double end = StageTimer::Now();
+    pthread_mutex_lock(&lock);
+    std::map<int,Row>::iterator it = rows.find(this->cycle);
+    if(it == rows.end()) {
+        Row row;
+        for(int m=0; m<Nstages; m++) {
+            row.seconds[m] = 0.0;
+            row.calls[m] = 0;
+            row.bytes[m] = 0;
+        }
+        row.first = this->start;
+        row.last = end;
+        it = rows.insert(std::pair<int,Row>(this->cycle,row)).first;
+    }
+    Row &row = it->second;
+    row.seconds[this->stage] += end - this->start;
+    row.calls[this->stage]++;
+    row.bytes[this->stage] += this->bytes;
+    if(this->start < row.first)
+        row.first = this->start;
+    if(end > row.last)
+        row.last = end;
+    pthread_mutex_unlock(&lock);
+}
+
+//============================================================================//
+void StageTimer::AddBytes(long bytes) {
+    // Adds bytes that are only known during the stage
+    this->bytes += bytes;
+}
+
+//============================================================================//
+void StageTimer::Start(void) {
+    // Turns the timers on (at the start of the session)
+    session_start = StageTimer::Now();
+    enabled = true;
+}
+
+//============================================================================//
+void StageTimer::Set_Cycle(int cycle) {
+    // Sets the cycle that the calling thread works on (0 for the session)
+    pthread_once(&cycle_once,Make_Cycle_Key);
+    pthread_setspecific(cycle_key,(void*)(long)cycle);
+}
+
+//============================================================================//
+int StageTimer::Get_Cycle(void) {
+    pthread_once(&cycle_once,Make_Cycle_Key);
+    return (int)(long)pthread_getspecific(cycle_key);
+}
+
+//============================================================================//
+double StageTimer::Now(void) {
+    struct timeval tv;
+    gettimeofday(&tv,NULL);
+    return tv.tv_sec + 1.0E-6*tv.tv_usec;
+}
+
+//============================================================================//
+void StageTimer::Write_Report(char *path, char *prefix, char *stopmsg) {
+    // Writes the rows and the totals to <path><prefix>.json and .csv
+    if(!enabled)
+        return;
+    double wall = StageTimer::Now() - session_start;
+    pthread_mutex_lock(&lock);
+    StageTimer::Write_JSON(path,prefix,stopmsg,wall);
+    StageTimer::Write_CSV(path,prefix,stopmsg,wall);
+    pthread_mutex_unlock(&lock);
+    cout << "      Timing:  " << path << prefix << ".json (.csv)\n";
+}
+
+//============================================================================//
+void StageTimer::Write_JSON(char *path, char *prefix, char *stopmsg,
+                            double wall) {
+    char fname[1001], outstr[1001];
+    int Ncycles = 0;
+    Row total;
+    std::map<int,Row>::iterator it;
+    for(int m=0; m<Nstages; m++) {
+        total.seconds[m] = 0.0;
+        total.calls[m] = 0;
+        total.bytes[m] = 0;
+    }
+    for(it=rows.begin(); it!=rows.end(); it++) {
+        if(it->first > 0)
+            Ncycles++;
+        for(int m=0; m<Nstages; m++) {
+            total.seconds[m] += it->second.seconds[m];
+            total.calls[m] += it->second.calls[m];
+            total.bytes[m] += it->second.bytes[m];
+        }
+    }
+
+    ofstream file;
+    sprintf(fname,"%s.json",prefix);
+    OpenOutputFile(file,path,fname,stopmsg);
+    sprintf(outstr,"{\n  \"wall_seconds\": %.6f,\n  \"cycles\": %d,\n",
+            wall,Ncycles);
+    file << outstr;
+    sprintf(outstr,"  \"cycles_per_second\": %.6f,\n  \"totals\": {\n",
+            (wall > 0.0) ? Ncycles/wall : 0.0);
+    file << outstr;
+    for(int m=0; m<Nstages; m++) {
+        sprintf(outstr,"    \"%s\": {\"calls\": %ld, \"seconds\": %.6f, "
+                "\"bytes\": %ld, \"MB_per_s\": %.3f}%s\n",stage_names[m],
+                total.calls[m],total.seconds[m],total.bytes[m],
+                MB_Rate(total.bytes[m],total.seconds[m]),
+                (m < Nstages-1) ? "," : "");
+        file << outstr;
+    }
+    file << "  },\n  \"rows\": [\n";
+    for(it=rows.begin(); it!=rows.end(); it++) {
+        Row &row = it->second;
+        sprintf(outstr,"    {\"cycle\": %d, \"wall_seconds\": %.6f, "
+                "\"stages\": {\n",it->first,row.last-row.first);
+        file << outstr;
+        for(int m=0; m<Nstages; m++) {
+            sprintf(outstr,"      \"%s\": {\"calls\": %ld, \"seconds\": %.6f, "
+                    "\"bytes\": %ld, \"MB_per_s\": %.3f}%s\n",stage_names[m],
+                    row.calls[m],row.seconds[m],row.bytes[m],
+                    MB_Rate(row.bytes[m],row.seconds[m]),
+                    (m < Nstages-1) ? "," : "");
+            file << outstr;
+        }
+        std::map<int,Row>::iterator next = it;
+        next++;
+        file << "    }}" << ((next != rows.end()) ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    file.close();
+}
+
+//============================================================================//
+void StageTimer::Write_CSV(char *path, char *prefix, char *stopmsg,
+                           double wall) {
+    char fname[1001], outstr[1001];
+    double seconds[Nstages];
+    long calls[Nstages], bytes[Nstages];
+    for(int m=0; m<Nstages; m++) {
+        seconds[m] = 0.0;
+        calls[m] = 0;
+        bytes[m] = 0;
+    }
+
+    ofstream file;
+    sprintf(fname,"%s.csv",prefix);
+    OpenOutputFile(file,path,fname,stopmsg);
+    file << "cycle,stage,calls,seconds,bytes,MB_per_s\n";
+    std::map<int,Row>::iterator it;
+    for(it=rows.begin(); it!=rows.end(); it++) {
+        Row &row = it->second;
+        for(int m=0; m<Nstages; m++) {
+            if(row.calls[m] == 0)
+                continue;
+            sprintf(outstr,"%d,%s,%ld,%.6f,%ld,%.3f\n",it->first,
+                    stage_names[m],row.calls[m],row.seconds[m],row.bytes[m],
+                    MB_Rate(row.bytes[m],row.seconds[m]));
+            file << outstr;
+            seconds[m] += row.seconds[m];
+            calls[m] += row.calls[m];
+            bytes[m] += row.bytes[m];
+        }
+    }
+    for(int m=0; m<Nstages; m++) {
+        sprintf(outstr,"total,%s,%ld,%.6f,%ld,%.3f\n",stage_names[m],calls[m],
+                seconds[m],bytes[m],
+                MB_Rate(bytes[m],seconds[m]));
+        file << outstr;
+    }
+    sprintf(outstr,"total,cycles,%d,%.6f,0,0.000\n",
+            (int)rows.size() - (int)rows.count(0),wall);
+    file << outstr;
+    file.close();
+}
+
+//============================================================================//
+//============================================================================//
@@ -0,0 +1,74 @@
+//============================================================================//
+/*
+
+Clayton Myers
+Stage_Timers.hpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Header file for the per-stage timers of the conversion and analysis drivers.
+
+*/
+//============================================================================//
+//============================================================================//
+
+#include <map>
+#include <pthread.h>
+
+//============================================================================//
+// Stages of the conversion and analysis paths:
+enum {
+    stage_index,         // Validation and indexing of the source files
+    stage_read,          // Binary reads (pread batches or mapped records)
+    stage_strip,         // Stripping of the HYM ghost zones
+    stage_ghost,         // Adding the SILO ghost planes
+    stage_cyl_to_cart,   // Cartesian transform (with ghost planes and zeros)
+    stage_zeros,         // Zero threshold (Set_Zeros)
+    stage_put,           // DBPut* calls
+    stage_close,         // DBClose calls
+    stage_analysis,      // Analysis kernels (quadrature, modes and probes)
+    Nstages
+};
+
+//============================================================================//
+// Scoped timer of one call of a stage.  The time, the bytes moved and the
+// call are added to the row of the cycle that the calling thread works on
+// (see Set_Cycle; cycle 0 is the session itself) when the timer goes out of
+// scope.  The timers cost nothing unless enabled, and Write_Report writes the
+// rows and their totals (seconds, calls, bytes, MB/s and cycles/s) as JSON
+// and CSV files.
+class StageTimer {
+    public:
+        static bool enabled;     // Record the stages (see Start)
+
+        StageTimer(int,long);
+        ~StageTimer(void);
+        void AddBytes(long);
+        static void Start(void);
+        static void Set_Cycle(int);
+        static void Write_Report(char*,char*,char*);
+
+    protected:
+        struct Row {
+            double seconds[Nstages];  // Time in each stage
+            long calls[Nstages];      // Calls of each stage
+            long bytes[Nstages];      // Bytes moved by each stage
+            double first, last;       // Span of the timed calls
+        };
+        int stage;               // Stage of this call
+        int cycle;               // Cycle of this call
+        long bytes;              // Bytes moved by this call
+        double start;            // Start time of this call
+
+        static double Now(void);
+        static int Get_Cycle(void);
+        static void Write_JSON(char*,char*,char*,double);
+        static void Write_CSV(char*,char*,char*,double);
+
+        static std::map<int,Row> rows;  // Row of each cycle (0 = session)
+        static double session_start;    // Time the timers were started
+        static pthread_mutex_t lock;    // Guards rows
+};
+
+//============================================================================//
+//============================================================================//
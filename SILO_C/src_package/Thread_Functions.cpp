@@ -0,0 +1,148 @@
+//============================================================================//
+/*
+
+Clayton Myers
+Thread_Functions.cpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Support functions for splitting kernels over threads.  Parallel_For divides an
+index range (normally the phi planes k) into contiguous slabs, one per thread.
+Parallel_Tasks runs independent tasks (e.g. the variables of one cycle) on 
+their own threads and splits the thread budget between them so that nested
+Parallel_For calls do not oversubscribe the node.
+
+*/
+//============================================================================//
+//============================================================================//
+
+#include <HYM_SILO.hpp>
+#include <Thread_Functions.hpp>
+#include <pthread.h>
+
+//============================================================================//
+//============================================================================//
+int Nthreads = 1;
+
+struct SlabArgs {
+    void (*func)(int,int,void*);  // Slab kernel
+    void *arg;                    // Kernel argument
+    int n1, n2;                   // Slab bounds [n1,n2)
+};
+
+struct TaskArgs {
+    void (*func)(int,void*);      // Task function
+    void *arg;                    // Task argument
+    int task;                     // Task index
+    int budget;                   // Thread budget for the task
+};
+
+void *Run_Slab(void*);
+void *Run_Task(void*);
+
+pthread_key_t budget_key;
+pthread_once_t budget_once = PTHREAD_ONCE_INIT;
+
+//============================================================================//
+//============================================================================//
+void Make_Budget_Key(void) {
+    pthread_key_create(&budget_key,NULL);
+}
+
+//============================================================================//
+void Set_Thread_Budget(int budget) {
+    // Sets the number of threads available to the calling thread
+    pthread_once(&budget_once,Make_Budget_Key);
+    pthread_setspecific(budget_key,(void*)(long)budget);
+}
+
+//============================================================================//
+int Get_Thread_Budget(void) {
+    // Threads without an explicit budget get the global thread count
+    pthread_once(&budget_once,Make_Budget_Key);
+    long budget = (long)pthread_getspecific(budget_key);
+    if(budget <= 0)
+        return (Nthreads > 1) ? Nthreads : 1;
+    return (int)budget;
+}
+
+//============================================================================//
+void Parallel_For(int N, void (*func)(int,int,void*), void *arg) {
+    // Calls func(n1,n2,arg) over contiguous slabs covering [0,N).  The first
+    // slab runs on the calling thread.
+    int Nt = Get_Thread_Budget();
+    if(Nt > N)
+        Nt = N;
+    if(Nt <= 1) {
+        if(N > 0)
+            func(0,N,arg);
+        return;
+    }
+    
+    pthread_t *threads = new pthread_t[Nt];
+    SlabArgs *slabs = new SlabArgs[Nt];
+    for(int t=0; t<Nt; t++) {
+        slabs[t].func = func;
+        slabs[t].arg = arg;
+        slabs[t].n1 = (int)(((long)N*t)/Nt);
+        slabs[t].n2 = (int)(((long)N*(t+1))/Nt);
+    }
+    for(int t=1; t<Nt; t++)
+        pthread_create(&threads[t],NULL,Run_Slab,&slabs[t]);
+    func(slabs[0].n1,slabs[0].n2,arg);
+    for(int t=1; t<Nt; t++)
+        pthread_join(threads[t],NULL);
+    
+    delete [] slabs;
+    delete [] threads;
+}
+
+//============================================================================//
+void Parallel_Tasks(int Ntasks, void (*func)(int,void*), void *arg) {
+    // Calls func(task,arg) for each task in [0,Ntasks) on its own thread.  The
+    // calling thread's budget is shared out between the tasks.
+    int Nt = Get_Thread_Budget();
+    if(Nt <= 1 || Ntasks <= 1) {
+        for(int m=0; m<Ntasks; m++)
+            func(m,arg);
+        return;
+    }
+    
+    pthread_t *threads = new pthread_t[Ntasks];
+    TaskArgs *tasks = new TaskArgs[Ntasks];
+    for(int m=0; m<Ntasks; m++) {
+        tasks[m].func = func;
+        tasks[m].arg = arg;
+        tasks[m].task = m;
+        // Spread the remainder over the first tasks:
+        tasks[m].budget = Nt/Ntasks + ((m < Nt%Ntasks) ? 1 : 0);
+        if(tasks[m].budget < 1)
+            tasks[m].budget = 1;
+    }
+    for(int m=0; m<Ntasks; m++)
+        pthread_create(&threads[m],NULL,Run_Task,&tasks[m]);
+    for(int m=0; m<Ntasks; m++)
+        pthread_join(threads[m],NULL);
+    
+    delete [] tasks;
+    delete [] threads;
+}
+
+//============================================================================//
+void *Run_Slab(void *arg) {
+    SlabArgs *slab = (SlabArgs*)arg;
+    Set_Thread_Budget(1);
+    slab->func(slab->n1,slab->n2,slab->arg);
+    return NULL;
+}
+
+//============================================================================//
+void *Run_Task(void *arg) {
+    TaskArgs *task = (TaskArgs*)arg;
+    Set_Thread_Budget(task->budget);
+    task->func(task->task,task->arg);
+    return NULL;
+}
+
+//============================================================================//
+//============================================================================//
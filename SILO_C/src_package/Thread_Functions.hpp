@@ -0,0 +1,23 @@
+//============================================================================//
+/*
+
+Clayton Myers
+Thread_Functions.hpp
+Created:  17 October 2026
+Modified: 17 October 2026
+
+Header file for the shared-memory threading support functions.
+
+*/
+//============================================================================//
+//============================================================================//
+
+extern int Nthreads;  // Number of threads for slab-parallel kernels
+
+void Set_Thread_Budget(int);
+int Get_Thread_Budget(void);
+void Parallel_For(int,void(*)(int,int,void*),void*);
+void Parallel_Tasks(int,void(*)(int,void*),void*);
+
+//============================================================================//
+//============================================================================//